@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include "pico/stdlib.h"
 #include "ra8876.h"
 
@@ -9,9 +11,27 @@ static ra8876_t display = {
     .pin_cs = 17,
     .pin_sck = 18,
     .pin_mosi = 19,
+#ifdef DEMO_8080_BUS
+    .transport = &ra8876_pio_8080_transport,
+    .pio = pio0,
+    .pin_data = 0,
+    .pin_wr = 20,
+    .pio_speed = 40000000,
+#endif
     .spi_speed = 20000000
 };
 
+static ra8876_t display2 = {
+    .spi = spi1,
+    .pin_miso = 12,
+    .pin_cs = 13,
+    .pin_sck = 10,
+    .pin_mosi = 11,
+    .spi_speed = 20000000
+};
+
+static bool display2_ok;
+
 void demo1_shapes(void) {
     printf("Demo 1: Shapes\n");
 
@@ -658,6 +678,8 @@ void demo7_cgram(void) {
     sleep_ms(5000);
 }
 
+static float internal_font_chars_per_sec;
+
 void demo8_internal_font_bench(void) {
     printf("Demo 8: Internal Font Benchmark\n");
 
@@ -711,6 +733,7 @@ void demo8_internal_font_bench(void) {
     printf("Internal Font Benchmark: 300 frames in %lu us\n", elapsed);
     printf("Average FPS: %.2f\n", avg_fps);
     printf("Chars/sec: %.0f\n", chars_per_sec);
+    internal_font_chars_per_sec = chars_per_sec;
 
     ra8876_buffer_disable(&display);
 
@@ -857,26 +880,50 @@ void demo10_cgram_cursor(void) {
     ra8876_select_internal_font(&display, RA8876_FONT_16, RA8876_ENC_8859_1);
 }
 
-#define LIFE_CELL_SIZE 8
-#define LIFE_COLS (1024 / LIFE_CELL_SIZE)
-#define LIFE_ROWS ((600 - 40) / LIFE_CELL_SIZE)
+#define LIFE_TOP 40
+#define LIFE_MIN_CELL 2
+#define LIFE_MAX_WORDS (1024 / LIFE_MIN_CELL / 32)
+#define LIFE_MAX_ROWS ((600 - LIFE_TOP) / LIFE_MIN_CELL)
+#define LIFE_BENCH_GENS 100
+
+static struct {
+    int cols, rows, words, cell, cur;
+    uint32_t grid[2][LIFE_MAX_ROWS][LIFE_MAX_WORDS];
+} life;
+
+typedef struct {
+    int y0, y1;
+} life_job_t;
+
+static void life_setup(int cell) {
+    life.cell = cell;
+    life.cols = display.width / cell;
+    if (life.cols > LIFE_MAX_WORDS * 32) life.cols = LIFE_MAX_WORDS * 32;
+    life.cols &= ~31;
+    life.rows = (display.height - LIFE_TOP) / cell;
+    if (life.rows > LIFE_MAX_ROWS) life.rows = LIFE_MAX_ROWS;
+    life.words = life.cols / 32;
+    life.cur = 0;
+    memset(life.grid, 0, sizeof(life.grid));
+}
 
-static uint8_t life_grid[LIFE_ROWS][LIFE_COLS];
-static uint8_t life_next[LIFE_ROWS][LIFE_COLS];
+static void life_set(int x, int y) {
+    if (x < life.cols && y < life.rows)
+        life.grid[life.cur][y][x >> 5] |= 1u << (x & 31);
+}
 
 static void life_init_random(void) {
-    for (int y = 0; y < LIFE_ROWS; y++) {
-        for (int x = 0; x < LIFE_COLS; x++) {
-            life_grid[y][x] = (rand() % 100) < 25 ? 1 : 0;
+    for (int y = 0; y < life.rows; y++) {
+        for (int w = 0; w < life.words; w++) {
+            uint32_t bits = 0;
+            for (int b = 0; b < 32; b++)
+                if ((rand() % 100) < 25) bits |= 1u << b;
+            life.grid[life.cur][y][w] = bits;
         }
     }
 }
 
 static void life_init_glider_gun(void) {
-    for (int y = 0; y < LIFE_ROWS; y++)
-        for (int x = 0; x < LIFE_COLS; x++)
-            life_grid[y][x] = 0;
-
     int ox = 10, oy = 10;
     int gun[][2] = {
         {0,4},{0,5},{1,4},{1,5},
@@ -887,106 +934,160 @@ static void life_init_glider_gun(void) {
         {34,2},{34,3},{35,2},{35,3}
     };
     int n = sizeof(gun) / sizeof(gun[0]);
-    for (int i = 0; i < n; i++) {
-        int x = ox + gun[i][0];
-        int y = oy + gun[i][1];
-        if (x < LIFE_COLS && y < LIFE_ROWS)
-            life_grid[y][x] = 1;
-    }
+    for (int i = 0; i < n; i++)
+        life_set(ox + gun[i][0], oy + gun[i][1]);
 }
 
-static int life_count_neighbors(int x, int y) {
-    int xm1 = (x == 0) ? LIFE_COLS - 1 : x - 1;
-    int xp1 = (x == LIFE_COLS - 1) ? 0 : x + 1;
-    int ym1 = (y == 0) ? LIFE_ROWS - 1 : y - 1;
-    int yp1 = (y == LIFE_ROWS - 1) ? 0 : y + 1;
-
-    return life_grid[ym1][xm1] + life_grid[ym1][x] + life_grid[ym1][xp1] +
-           life_grid[y][xm1] + life_grid[y][xp1] +
-           life_grid[yp1][xm1] + life_grid[yp1][x] + life_grid[yp1][xp1];
+static inline void life_add(uint32_t *s0, uint32_t *s1, uint32_t *s2, uint32_t x) {
+    uint32_t c0 = *s0 & x;
+    *s0 ^= x;
+    uint32_t c1 = *s1 & c0;
+    *s1 ^= c0;
+    *s2 |= c1;
 }
 
-static void life_step(void) {
-    for (int y = 0; y < LIFE_ROWS; y++) {
-        for (int x = 0; x < LIFE_COLS; x++) {
-            int n = life_count_neighbors(x, y);
-            if (life_grid[y][x]) {
-                life_next[y][x] = (n == 2 || n == 3) ? 1 : 0;
-            } else {
-                life_next[y][x] = (n == 3) ? 1 : 0;
+static void life_step_rows(int y0, int y1) {
+    uint32_t (*cur)[LIFE_MAX_WORDS] = life.grid[life.cur];
+    uint32_t (*next)[LIFE_MAX_WORDS] = life.grid[life.cur ^ 1];
+    int n = life.words;
+
+    for (int y = y0; y < y1; y++) {
+        const uint32_t *rows[3] = {
+            cur[y == 0 ? life.rows - 1 : y - 1],
+            cur[y],
+            cur[y == life.rows - 1 ? 0 : y + 1]
+        };
+        for (int w = 0; w < n; w++) {
+            int wl = w == 0 ? n - 1 : w - 1;
+            int wr = w == n - 1 ? 0 : w + 1;
+            uint32_t s0 = 0, s1 = 0, s2 = 0;
+            for (int r = 0; r < 3; r++) {
+                const uint32_t *row = rows[r];
+                life_add(&s0, &s1, &s2, (row[w] << 1) | (row[wl] >> 31));
+                life_add(&s0, &s1, &s2, (row[w] >> 1) | (row[wr] << 31));
+                if (r != 1) life_add(&s0, &s1, &s2, row[w]);
             }
+            next[y][w] = ~s2 & s1 & (s0 | cur[y][w]);
         }
     }
-    for (int y = 0; y < LIFE_ROWS; y++)
-        for (int x = 0; x < LIFE_COLS; x++)
-            life_grid[y][x] = life_next[y][x];
 }
 
-static void life_draw(uint8_t page) {
-    ra8876_bte_solid_fill(&display, ra8876_page_addr(&display, page), 0, 40, display.width, display.height - 40, RA8876_BLACK);
+static void life_step_job(void *arg) {
+    life_job_t *job = arg;
+    life_step_rows(job->y0, job->y1);
+}
+
+static void life_step(bool dual) {
+    if (dual) {
+        life_job_t job = { life.rows / 2, life.rows };
+        ra8876_core1_run(life_step_job, &job);
+        life_step_rows(0, job.y0);
+        ra8876_core1_wait();
+    } else {
+        life_step_rows(0, life.rows);
+    }
+    life.cur ^= 1;
+}
 
-    ra8876_bte_batch_start(&display, ra8876_page_addr(&display, page), LIFE_CELL_SIZE - 1, LIFE_CELL_SIZE - 1);
-    for (int y = 0; y < LIFE_ROWS; y++) {
-        for (int x = 0; x < LIFE_COLS; x++) {
-            if (life_grid[y][x]) {
-                uint16_t px = x * LIFE_CELL_SIZE;
-                uint16_t py = 40 + y * LIFE_CELL_SIZE;
-                ra8876_bte_batch_fill(&display, px, py, RA8876_GREEN);
+static uint32_t life_draw_cells(bool births, uint32_t color) {
+    uint32_t (*now)[LIFE_MAX_WORDS] = life.grid[life.cur];
+    uint32_t (*was)[LIFE_MAX_WORDS] = life.grid[life.cur ^ 1];
+    uint32_t cells = 0;
+
+    for (int y = 0; y < life.rows; y++) {
+        uint16_t py = LIFE_TOP + y * life.cell;
+        for (int w = 0; w < life.words; w++) {
+            uint32_t d = (now[y][w] ^ was[y][w]) & (births ? now[y][w] : was[y][w]);
+            while (d) {
+                int b = __builtin_ctz(d);
+                d &= d - 1;
+                ra8876_bte_batch_fill(&display, (w * 32 + b) * life.cell, py, color);
+                cells++;
             }
         }
     }
-    ra8876_wait_task_busy(&display);
+    return cells;
+}
+
+static uint32_t life_draw(void) {
+    uint16_t size = life.cell > 2 ? life.cell - 1 : life.cell;
+    ra8876_bte_batch_start(&display, display.canvas_addr, size, size);
+    uint32_t cells = life_draw_cells(true, RA8876_GREEN);
+    return cells + life_draw_cells(false, RA8876_BLACK);
+}
+
+static void life_status(const char *text) {
+    ra8876_bte_solid_fill(&display, display.canvas_addr, 0, 0, display.width, LIFE_TOP, ra8876_rgb(0, 0, 60));
+    ra8876_print(&display, 10, 10, RA8876_WHITE, text);
+}
+
+static void life_show(void) {
+    ra8876_bte_solid_fill(&display, display.canvas_addr, 0, LIFE_TOP, display.width, display.height - LIFE_TOP, RA8876_BLACK);
+    life_draw();
 }
 
 void demo11_game_of_life(void) {
     printf("Demo 11: Conway's Game of Life\n");
 
+    char text[96];
     srand(time_us_32());
+    ra8876_set_canvas_page(&display, 0);
+    ra8876_set_display_addr(&display, display.canvas_addr);
+    ra8876_select_internal_font(&display, RA8876_FONT_16, RA8876_ENC_8859_1);
+    ra8876_core1_start();
 
+    life_setup(8);
     life_init_glider_gun();
+    snprintf(text, sizeof(text), "Game of Life  Glider gun  Grid: %dx%d", life.cols, life.rows);
+    life_status(text);
+    life_show();
+    for (int gen = 0; gen < 200; gen++) {
+        life_step(false);
+        life_draw();
+        sleep_ms(20);
+    }
 
-    ra8876_buffer_init(&display, 2);
-
-    uint32_t gen = 0;
-    uint32_t frames = 0;
-    uint32_t fps = 0;
-    uint32_t last_fps_time = time_us_32();
-
-    for (int i = 0; i < 1000; i++) {
-        uint8_t draw_page = ra8876_get_draw_page(&display);
-
-        ra8876_bte_solid_fill(&display, ra8876_page_addr(&display, draw_page), 0, 0, display.width, 40, ra8876_rgb(0, 0, 60));
-
-        life_draw(draw_page);
-
-        ra8876_set_canvas_page(&display, draw_page);
-        ra8876_select_internal_font(&display, RA8876_FONT_16, RA8876_ENC_8859_1);
-        ra8876_printf(&display, 10, 10, RA8876_WHITE, "Game of Life  Gen: %lu  FPS: %lu  Grid: %dx%d", gen, fps, LIFE_COLS, LIFE_ROWS);
-
-        ra8876_swap_buffers(&display);
-
-        life_step();
-        gen++;
-
-        frames++;
-        uint32_t now = time_us_32();
-        if (now - last_fps_time >= 1000000) {
-            fps = frames;
-            frames = 0;
-            last_fps_time = now;
-            printf("Life FPS: %lu, Gen: %lu\n", fps, gen);
-        }
-
-        if (gen == 200) {
+    static const uint8_t cells[] = { 8, 4, 2 };
+    uint32_t seed = rand();
+    for (int c = 0; c < (int)(sizeof(cells) / sizeof(cells[0])); c++) {
+        for (int dual = 0; dual < 2; dual++) {
+            life_setup(cells[c]);
+            srand(seed);
             life_init_random();
-            gen = 0;
+            snprintf(text, sizeof(text), "Game of Life  Grid: %dx%d  Cores: %d  running %d generations",
+                     life.cols, life.rows, dual + 1, LIFE_BENCH_GENS);
+            life_status(text);
+            life_show();
+
+            uint32_t step_us = 0, changed = 0;
+            uint32_t bytes = display.spi_bytes;
+            uint32_t t0 = time_us_32();
+            for (int gen = 0; gen < LIFE_BENCH_GENS; gen++) {
+                uint32_t t1 = time_us_32();
+                life_step(dual);
+                step_us += time_us_32() - t1;
+                changed += life_draw();
+            }
+            uint32_t total_us = time_us_32() - t0;
+            bytes = display.spi_bytes - bytes;
+            if (step_us == 0) step_us = 1;
+
+            uint32_t gps = (uint32_t)((uint64_t)LIFE_BENCH_GENS * 1000000 / total_us);
+            uint32_t step_gps = (uint32_t)((uint64_t)LIFE_BENCH_GENS * 1000000 / step_us);
+            printf("Life %dx%d %d core: %lu gen/s, step only %lu gen/s, %lu SPI bytes/gen, %lu cells/gen\n",
+                   life.cols, life.rows, dual + 1, gps, step_gps, bytes / LIFE_BENCH_GENS, changed / LIFE_BENCH_GENS);
+            snprintf(text, sizeof(text), "Grid: %dx%d  Cores: %d  %lu gen/s  step %lu gen/s  %lu B/gen",
+                     life.cols, life.rows, dual + 1, gps, step_gps, bytes / LIFE_BENCH_GENS);
+            life_status(text);
+            sleep_ms(1500);
         }
     }
 
-    ra8876_buffer_disable(&display);
     printf("Game of Life demo complete\n");
 }
 
+static ra8876_frame_t draw_frame;
+
 #define PLAT_GROUND_Y       500
 #define PLAT_PLAYER_W       24
 #define PLAT_PLAYER_H       32
@@ -1137,43 +1238,57 @@ static void plat_update(void) {
     }
 }
 
+static bool plat_batched;
+static uint32_t plat_pixels;
+
+static void plat_fill(uint32_t addr, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    if (plat_batched) {
+        ra8876_frame_fill(&display, &draw_frame, x, y, w, h, color);
+        return;
+    }
+    ra8876_bte_solid_fill_s(&display, addr, x, y, w, h, color);
+    int32_t x0 = x < 0 ? 0 : x, x1 = x + w > display.width ? display.width : x + w;
+    int32_t y0 = y < 0 ? 0 : y, y1 = y + h > display.height ? display.height : y + h;
+    if (x1 > x0 && y1 > y0) plat_pixels += (x1 - x0) * (y1 - y0);
+}
+
 static void plat_draw(uint8_t page) {
     uint32_t addr = ra8876_page_addr(&display, page);
 
-    ra8876_bte_solid_fill(&display, addr, 0, 0, display.width, display.height, ra8876_rgb(40, 44, 52));
+    plat_pixels = 0;
+    if (plat_batched) ra8876_frame_begin(&draw_frame, addr);
+
+    plat_fill(addr, 0, 0, display.width, display.height, ra8876_rgb(40, 44, 52));
 
     for (int i = 0; i < 6; i++) {
         int16_t mx = ((i * 200) - (bg_scroll / 3) % 200 + 1200) % 1200 - 100;
-        if (mx >= 0 && mx + 60 < (int16_t)display.width)
-            ra8876_bte_solid_fill(&display, addr, mx, 80 + i * 15, 60, 40, ra8876_rgb(60, 64, 72));
+        plat_fill(addr, mx, 80 + i * 15, 60, 40, ra8876_rgb(60, 64, 72));
     }
 
-    ra8876_bte_solid_fill(&display, addr, 0, PLAT_GROUND_Y, display.width, display.height - PLAT_GROUND_Y, ra8876_rgb(60, 40, 30));
-    ra8876_bte_solid_fill(&display, addr, 0, PLAT_GROUND_Y, display.width, 5, ra8876_rgb(80, 60, 40));
+    plat_fill(addr, 0, PLAT_GROUND_Y, display.width, display.height - PLAT_GROUND_Y, ra8876_rgb(60, 40, 30));
+    plat_fill(addr, 0, PLAT_GROUND_Y, display.width, 5, ra8876_rgb(80, 60, 40));
 
     for (int i = 0; i < PLAT_MAX_PLATFORMS; i++) {
-        int16_t px = platforms[i].x - scroll_x;
-        if (px > -platforms[i].w && px < (int16_t)display.width) {
-            int16_t draw_x = (px < 0) ? 0 : px;
-            int16_t draw_w = platforms[i].w - ((px < 0) ? -px : 0);
-            if (draw_x + draw_w > (int16_t)display.width) draw_w = display.width - draw_x;
-            if (draw_w > 0) {
-                ra8876_bte_solid_fill(&display, addr, draw_x, platforms[i].y, draw_w, platforms[i].h, platforms[i].color);
-                ra8876_bte_solid_fill(&display, addr, draw_x, platforms[i].y, draw_w, 4, ra8876_rgb(100, 200, 100));
-            }
-        }
+        int32_t px = platforms[i].x - scroll_x;
+        plat_fill(addr, px, platforms[i].y, platforms[i].w, platforms[i].h, platforms[i].color);
+        plat_fill(addr, px, platforms[i].y, platforms[i].w, 4, ra8876_rgb(100, 200, 100));
     }
 
     uint32_t body_color = ra8876_rgb(220, 120, 100);
     uint32_t head_color = ra8876_rgb(255, 200, 180);
 
-    ra8876_bte_solid_fill(&display, addr, player.x, player.y + 10, PLAT_PLAYER_W, PLAT_PLAYER_H - 10, body_color);
-    ra8876_bte_solid_fill(&display, addr, player.x + 4, player.y, 16, 14, head_color);
+    plat_fill(addr, player.x, player.y + 10, PLAT_PLAYER_W, PLAT_PLAYER_H - 10, body_color);
+    plat_fill(addr, player.x + 4, player.y, 16, 14, head_color);
 
     int leg_offset = (scroll_x / 4) % 8;
     if (!player.on_ground) leg_offset = 4;
-    ra8876_bte_solid_fill(&display, addr, player.x + 4, player.y + PLAT_PLAYER_H, 4, leg_offset, body_color);
-    ra8876_bte_solid_fill(&display, addr, player.x + PLAT_PLAYER_W - 8, player.y + PLAT_PLAYER_H, 4, 8 - leg_offset, body_color);
+    plat_fill(addr, player.x + 4, player.y + PLAT_PLAYER_H, 4, leg_offset, body_color);
+    plat_fill(addr, player.x + PLAT_PLAYER_W - 8, player.y + PLAT_PLAYER_H, 4, 8 - leg_offset, body_color);
+
+    if (plat_batched) {
+        ra8876_frame_flush(&display, &draw_frame);
+        plat_pixels = draw_frame.px_out;
+    }
 }
 
 void demo12_platformer(void) {
@@ -1187,12 +1302,20 @@ void demo12_platformer(void) {
     uint32_t frames = 0;
     uint32_t fps = 0;
     uint32_t last_fps_time = time_us_32();
+    uint32_t draw_us[2] = { 0, 0 }, pixels[2] = { 0, 0 };
 
     for (int i = 0; i < 3000; i++) {
         uint8_t draw_page = ra8876_get_draw_page(&display);
 
         plat_update();
-        plat_draw(draw_page);
+        for (int k = 0; k < 2; k++) {
+            plat_batched = (i + k) & 1;
+            uint32_t t0 = time_us_32();
+            plat_draw(draw_page);
+            ra8876_wait_task_busy(&display);
+            draw_us[plat_batched] += time_us_32() - t0;
+            pixels[plat_batched] += plat_pixels;
+        }
 
         ra8876_set_canvas_page(&display, draw_page);
         ra8876_select_internal_font(&display, RA8876_FONT_16, RA8876_ENC_8859_1);
@@ -1212,6 +1335,9 @@ void demo12_platformer(void) {
     }
 
     ra8876_buffer_disable(&display);
+    plat_batched = false;
+    printf("Platformer draw (same 3000 frames both ways): direct %lu px %lu us/frame, frame batch %lu px %lu us/frame\n",
+           pixels[0] / 3000, draw_us[0] / 3000, pixels[1] / 3000, draw_us[1] / 3000);
     printf("Platformer demo complete\n");
 }
 
@@ -1433,6 +1559,1480 @@ void demo15_cgram_inv(void) {
     ra8876_select_internal_font(&display, RA8876_FONT_16, RA8876_ENC_8859_1);
 }
 
+void demo16_text_batch_bench(void) {
+    printf("Demo 16: Text Batch Benchmark\n");
+
+    ra8876_buffer_init(&display, 2);
+
+    uint16_t cols = display.width / 8;
+    uint16_t rows = display.height / 16;
+    uint16_t total_chars = cols * rows;
+
+    char line[129];
+    char fps_line[32];
+
+    printf("Benchmarking Text Batch: %d cols x %d rows = %d chars\n", cols, rows, total_chars);
+
+    uint32_t frames = 0;
+    uint32_t start_time = time_us_32();
+    uint32_t fps = 0;
+    uint32_t last_fps_time = start_time;
+
+    ra8876_select_internal_font(&display, RA8876_FONT_16, RA8876_ENC_8859_1);
+    ra8876_set_text_colors(&display, RA8876_GREEN, RA8876_BLACK);
+
+    for (int f = 0; f < 300; f++) {
+        ra8876_text_begin(&display);
+
+        for (int row = 0; row < rows; row++) {
+            for (int i = 0; i < cols; i++) {
+                line[i] = ' ' + ((i + row + f) % 95);
+            }
+            line[cols] = '\0';
+
+            ra8876_text_run(&display, 0, row * 16, RA8876_GREEN, line);
+        }
+
+        snprintf(fps_line, sizeof(fps_line), "FPS: %lu", fps);
+        ra8876_text_run(&display, 10, display.height - 20, RA8876_WHITE, fps_line);
+
+        ra8876_text_end(&display);
+
+        ra8876_swap_buffers(&display);
+        frames++;
+        uint32_t now = time_us_32();
+        if (now - last_fps_time >= 1000000) {
+            fps = frames;
+            frames = 0;
+            last_fps_time = now;
+            printf("Text Batch FPS: %lu\n", fps);
+        }
+    }
+
+    uint32_t elapsed = time_us_32() - start_time;
+    float avg_fps = 300.0f * 1000000.0f / elapsed;
+    float chars_per_sec = (float)total_chars * 300.0f * 1000000.0f / elapsed;
+    float speedup = internal_font_chars_per_sec > 0 ? chars_per_sec / internal_font_chars_per_sec : 0;
+
+    printf("Text Batch Benchmark: 300 frames in %lu us\n", elapsed);
+    printf("Average FPS: %.2f\n", avg_fps);
+    printf("Chars/sec: %.0f (demo8: %.0f, %.2fx)\n", chars_per_sec, internal_font_chars_per_sec, speedup);
+
+    ra8876_buffer_disable(&display);
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_printf(&display, 10, 10, RA8876_WHITE, "Text Batch Benchmark Complete");
+    ra8876_printf(&display, 10, 40, RA8876_GREEN, "300 frames: %lu us", elapsed);
+    ra8876_printf(&display, 10, 70, RA8876_CYAN, "Average FPS: %.2f", avg_fps);
+    ra8876_printf(&display, 10, 100, RA8876_YELLOW, "Chars/sec: %.0f", chars_per_sec);
+    ra8876_printf(&display, 10, 130, RA8876_MAGENTA, "put_string: %.0f chars/sec (%.2fx)", internal_font_chars_per_sec, speedup);
+
+    sleep_ms(5000);
+}
+
+void demo17_hud_fields(void) {
+    printf("Demo 17: Incremental HUD Fields\n");
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_fill_rect(&display, 0, 0, display.width, 31, RA8876_DARKGRAY);
+    ra8876_print(&display, 10, 8, RA8876_WHITE, "HUD Fields - only changed characters are redrawn");
+
+    ra8876_field_t fps_field, frame_field, temp_field, volt_field, state_field;
+    ra8876_field_init(&fps_field, 10, 60, 12, RA8876_GREEN, RA8876_BLACK);
+    ra8876_field_init(&frame_field, 10, 90, 20, RA8876_WHITE, RA8876_BLACK);
+    ra8876_field_init(&temp_field, 10, 120, 20, RA8876_YELLOW, RA8876_BLACK);
+    ra8876_field_init(&volt_field, 10, 150, 20, RA8876_CYAN, RA8876_BLACK);
+    ra8876_field_init(&state_field, 10, 180, 20, RA8876_ORANGE, RA8876_BLACK);
+
+    uint32_t frames = 0;
+    uint32_t fps = 0;
+    uint32_t last_fps_time = time_us_32();
+    uint32_t field_bytes = 0;
+    uint32_t idle_frames = 0;
+
+    for (int i = 0; i < 600; i++) {
+        uint32_t before = display.spi_bytes;
+
+        ra8876_field_printf(&display, &fps_field, "FPS: %lu", fps);
+        ra8876_field_printf(&display, &frame_field, "Frame: %d", i / 10);
+        ra8876_field_printf(&display, &temp_field, "Temp: %d.%d C", 21 + (i / 120), (i / 30) % 10);
+        ra8876_field_printf(&display, &volt_field, "Vbat: %d mV", 3700 - i / 60);
+        ra8876_field_set(&display, &state_field, (i / 200) % 2 ? "State: RUNNING" : "State: IDLE");
+
+        uint32_t used = display.spi_bytes - before;
+        field_bytes += used;
+        if (used == 0) idle_frames++;
+
+        ra8876_wait_vsync(&display);
+
+        frames++;
+        uint32_t now = time_us_32();
+        if (now - last_fps_time >= 1000000) {
+            fps = frames;
+            frames = 0;
+            last_fps_time = now;
+        }
+    }
+
+    uint32_t before = display.spi_bytes;
+    for (int i = 0; i < 60; i++) {
+        ra8876_printf(&display, 400, 60, RA8876_GREEN, "FPS: %-7lu", fps);
+        ra8876_printf(&display, 400, 90, RA8876_WHITE, "Frame: %-13d", i / 10);
+        ra8876_printf(&display, 400, 120, RA8876_YELLOW, "Temp: %d.%d C      ", 21, (i / 30) % 10);
+        ra8876_printf(&display, 400, 150, RA8876_CYAN, "Vbat: %d mV      ", 3700);
+        ra8876_print(&display, 400, 180, RA8876_ORANGE, "State: IDLE         ");
+    }
+    uint32_t printf_bytes = (display.spi_bytes - before) / 60;
+
+    printf("HUD fields: %lu SPI bytes/frame avg, %lu of 600 frames with zero traffic\n",
+        field_bytes / 600, idle_frames);
+    printf("ra8876_printf HUD: %lu SPI bytes/frame\n", printf_bytes);
+
+    ra8876_printf(&display, 10, 240, RA8876_WHITE, "Fields: %lu bytes/frame, %lu/600 idle frames", field_bytes / 600, idle_frames);
+    ra8876_printf(&display, 10, 270, RA8876_WHITE, "printf: %lu bytes/frame", printf_bytes);
+
+    sleep_ms(5000);
+}
+
+void demo18_polyline(void) {
+    printf("Demo 18: Polyline Trend Chart\n");
+
+    static ra8876_point_t trend[1000];
+    int32_t v = 300;
+    for (int i = 0; i < 1000; i++) {
+        v += (rand() % 21) - 10;
+        if (v < 100) v = 100;
+        if (v > 560) v = 560;
+        trend[i].x = 12 + i;
+        trend[i].y = v;
+    }
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_print(&display, 10, 10, RA8876_WHITE, "Polyline vs draw_line loop (1000 points)");
+
+    const int runs = 20;
+    uint32_t bytes_before = display.spi_bytes;
+    uint32_t t0 = time_us_32();
+    for (int r = 0; r < runs; r++) {
+        for (int i = 1; i < 1000; i++)
+            ra8876_draw_line(&display, trend[i - 1].x, trend[i - 1].y, trend[i].x, trend[i].y, r & 1 ? RA8876_RED : RA8876_BLUE);
+    }
+    uint32_t line_us = time_us_32() - t0;
+    uint32_t line_bytes = (display.spi_bytes - bytes_before) / runs;
+
+    bytes_before = display.spi_bytes;
+    t0 = time_us_32();
+    for (int r = 0; r < runs; r++)
+        ra8876_draw_polyline(&display, trend, 1000, r & 1 ? RA8876_GREEN : RA8876_YELLOW);
+    uint32_t poly_us = time_us_32() - t0;
+    uint32_t poly_bytes = (display.spi_bytes - bytes_before) / runs;
+
+    float line_sps = 999.0f * runs * 1000000.0f / line_us;
+    float poly_sps = 999.0f * runs * 1000000.0f / poly_us;
+
+    printf("draw_line loop: %.0f segments/sec, %lu SPI bytes/chart\n", line_sps, line_bytes);
+    printf("draw_polyline:  %.0f segments/sec, %lu SPI bytes/chart (%.2fx)\n", poly_sps, poly_bytes, poly_sps / line_sps);
+
+    ra8876_point_t star[11];
+    for (int i = 0; i < 11; i++) {
+        float a = i * 3.14159265f * 4.0f / 10.0f;
+        star[i].x = 900 + (int16_t)(sinf(a) * 200);
+        star[i].y = 300 - (int16_t)(cosf(a) * 200);
+    }
+    ra8876_draw_polygon(&display, star, 10, RA8876_CYAN);
+
+    ra8876_point_t fan[17];
+    fan[0].x = 0;
+    fan[0].y = 599;
+    for (int i = 1; i < 17; i++) {
+        fan[i].x = -200 + i * 80;
+        fan[i].y = 450;
+    }
+    ra8876_draw_line_fan(&display, fan, 17, RA8876_MAGENTA);
+
+    ra8876_printf(&display, 10, 40, RA8876_WHITE, "draw_line: %.0f seg/s  %lu bytes", line_sps, line_bytes);
+    ra8876_printf(&display, 10, 60, RA8876_WHITE, "polyline:  %.0f seg/s  %lu bytes", poly_sps, poly_bytes);
+
+    sleep_ms(5000);
+}
+
+void demo19_strip_chart(void) {
+    printf("Demo 19: Scrolling Strip Chart\n");
+
+    static int16_t history[1000 * 3];
+    static ra8876_point_t naive[3][1000];
+    const uint32_t colors[3] = { RA8876_GREEN, RA8876_YELLOW, RA8876_CYAN };
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_print(&display, 10, 10, RA8876_WHITE, "Strip chart: SDRAM ring vs full redraw");
+
+    ra8876_chart_t chart;
+    if (!ra8876_chart_init(&display, &chart, 12, 80, 1000, 400, history, 3, colors)) {
+        printf("chart: no SDRAM for ring\n");
+        return;
+    }
+    ra8876_chart_set_colors(&chart, RA8876_BLACK, RA8876_DARKGRAY, 50);
+
+    const int samples = 3000;
+    const int per_update = 4;
+    float phase = 0.0f;
+    int16_t s[3];
+    uint32_t bytes_before = display.spi_bytes;
+    uint32_t t0 = time_us_32();
+    for (int i = 0; i < samples; i++) {
+        phase += 0.02f;
+        s[0] = (int16_t)(sinf(phase) * 1000);
+        s[1] = (int16_t)(sinf(phase * 3.1f) * 400 + (rand() % 100));
+        s[2] = (int16_t)(cosf(phase * 0.7f) * (600 + i / 4));
+        ra8876_chart_push(&chart, s);
+        if ((i + 1) % per_update == 0)
+            ra8876_chart_update(&display, &chart, display.canvas_addr);
+    }
+    uint32_t ring_us = time_us_32() - t0;
+    uint32_t ring_bytes = (display.spi_bytes - bytes_before) / (samples / per_update);
+
+    bytes_before = display.spi_bytes;
+    t0 = time_us_32();
+    const int naive_samples = 400;
+    for (int i = 0; i < naive_samples; i++) {
+        phase += 0.02f;
+        s[0] = (int16_t)(sinf(phase) * 1000);
+        s[1] = (int16_t)(sinf(phase * 3.1f) * 400 + (rand() % 100));
+        s[2] = (int16_t)(cosf(phase * 0.7f) * 1200);
+        ra8876_chart_push(&chart, s);
+        if ((i + 1) % per_update) continue;
+        ra8876_fill_rect(&display, 12, 80, 1000, 400, RA8876_BLACK);
+        for (int t = 0; t < 3; t++) {
+            for (int k = 0; k < 1000; k++) {
+                uint32_t n = chart.total - 1000 + k;
+                int32_t v = history[(n % 1000) * 3 + t];
+                naive[t][k].x = 12 + k;
+                naive[t][k].y = 80 + 399 - (v - chart.lo) * 399 / (chart.hi - chart.lo);
+            }
+            ra8876_draw_polyline(&display, naive[t], 1000, colors[t]);
+        }
+    }
+    uint32_t naive_us = time_us_32() - t0;
+    uint32_t naive_bytes = (display.spi_bytes - bytes_before) / (naive_samples / per_update);
+
+    ra8876_chart_update(&display, &chart, display.canvas_addr);
+
+    float ring_sps = samples * 1000000.0f / ring_us;
+    float naive_sps = naive_samples * 1000000.0f / naive_us;
+    printf("Ring chart:   %.0f samples/sec, %lu SPI bytes/update\n", ring_sps, ring_bytes);
+    printf("Full redraw:  %.0f samples/sec, %lu SPI bytes/update (%.1fx)\n", naive_sps, naive_bytes, ring_sps / naive_sps);
+
+    ra8876_printf(&display, 10, 500, RA8876_WHITE, "Ring:   %.0f samples/s  %lu bytes/update", ring_sps, ring_bytes);
+    ra8876_printf(&display, 10, 530, RA8876_WHITE, "Redraw: %.0f samples/s  %lu bytes/update", naive_sps, naive_bytes);
+
+    ra8876_sdram_release(&display, chart.ring_addr);
+    sleep_ms(5000);
+}
+
+static void scanline_fill(const ra8876_point_t *pts, int n, uint32_t color) {
+    int miny = pts[0].y, maxy = pts[0].y;
+    for (int i = 1; i < n; i++) {
+        if (pts[i].y < miny) miny = pts[i].y;
+        if (pts[i].y > maxy) maxy = pts[i].y;
+    }
+    int16_t xs[RA8876_POLYGON_MAX];
+    for (int y = miny; y <= maxy; y++) {
+        int k = 0;
+        for (int i = 0; i < n; i++) {
+            ra8876_point_t a = pts[i], b = pts[(i + 1) % n];
+            if ((a.y <= y && b.y > y) || (b.y <= y && a.y > y))
+                xs[k++] = a.x + (int32_t)(b.x - a.x) * (y - a.y) / (b.y - a.y);
+        }
+        for (int i = 1; i < k; i++) {
+            int16_t v = xs[i];
+            int j = i - 1;
+            for (; j >= 0 && xs[j] > v; j--) xs[j + 1] = xs[j];
+            xs[j + 1] = v;
+        }
+        for (int i = 0; i + 1 < k; i += 2) {
+            if (xs[i + 1] > xs[i])
+                ra8876_fill_rect(&display, xs[i], y, xs[i + 1] - xs[i], 1, color);
+        }
+    }
+}
+
+static int make_needle(ra8876_point_t *p, int cx, int cy, float angle) {
+    const float shape[7][2] = { {-20, -8}, {150, -3}, {150, -10}, {190, 0}, {150, 10}, {150, 3}, {-20, 8} };
+    float c = cosf(angle), s = sinf(angle);
+    for (int i = 0; i < 7; i++) {
+        p[i].x = cx + (int16_t)(shape[i][0] * c - shape[i][1] * s);
+        p[i].y = cy + (int16_t)(shape[i][0] * s + shape[i][1] * c);
+    }
+    return 7;
+}
+
+static int make_map_shape(ra8876_point_t *p, int cx, int cy) {
+    int n = 40;
+    for (int i = 0; i < n; i++) {
+        float a = i * 2.0f * 3.14159265f / n;
+        float r = 120 + 60 * sinf(a * 3) + 30 * cosf(a * 7);
+        p[i].x = cx + (int16_t)(r * cosf(a));
+        p[i].y = cy + (int16_t)(r * sinf(a) * 0.8f);
+    }
+    return n;
+}
+
+void demo20_polygon_fill(void) {
+    printf("Demo 20: Polygon Fill\n");
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_print(&display, 10, 10, RA8876_WHITE, "Triangle decomposition vs scanline rects");
+
+    ra8876_point_t pts[RA8876_POLYGON_MAX];
+    const int needles = 100;
+    uint32_t t0 = time_us_32();
+    for (int i = 0; i < needles; i++) {
+        int n = make_needle(pts, 250, 300, i * 0.0314f * 2);
+        scanline_fill(pts, n, i & 1 ? RA8876_RED : RA8876_ORANGE);
+    }
+    uint32_t needle_scan_us = time_us_32() - t0;
+
+    t0 = time_us_32();
+    for (int i = 0; i < needles; i++) {
+        int n = make_needle(pts, 250, 300, i * 0.0314f * 2);
+        ra8876_fill_polygon(&display, pts, n, i & 1 ? RA8876_GREEN : RA8876_CYAN);
+    }
+    uint32_t needle_tri_us = time_us_32() - t0;
+
+    int n = make_map_shape(pts, 750, 300);
+    const int maps = 20;
+    t0 = time_us_32();
+    for (int i = 0; i < maps; i++)
+        scanline_fill(pts, n, i & 1 ? RA8876_RED : RA8876_ORANGE);
+    uint32_t map_scan_us = time_us_32() - t0;
+
+    t0 = time_us_32();
+    for (int i = 0; i < maps; i++)
+        ra8876_fill_polygon(&display, pts, n, i & 1 ? RA8876_BLUE : RA8876_MAGENTA);
+    uint32_t map_tri_us = time_us_32() - t0;
+
+    printf("Gauge needle: scanline %lu us, triangles %lu us (%.1fx)\n",
+        needle_scan_us / needles, needle_tri_us / needles, (float)needle_scan_us / needle_tri_us);
+    printf("Map shape:    scanline %lu us, triangles %lu us (%.1fx)\n",
+        map_scan_us / maps, map_tri_us / maps, (float)map_scan_us / map_tri_us);
+
+    ra8876_printf(&display, 10, 540, RA8876_WHITE, "Needle: scan %lu us  tri %lu us", needle_scan_us / needles, needle_tri_us / needles);
+    ra8876_printf(&display, 10, 570, RA8876_WHITE, "Map:    scan %lu us  tri %lu us", map_scan_us / maps, map_tri_us / maps);
+
+    sleep_ms(5000);
+}
+
+static uint8_t rle_asset[96 * 1024];
+
+static size_t build_rle_landscape(uint16_t w, uint16_t h) {
+    static uint8_t row[1024];
+    size_t size = ra8876_rle_write_header(rle_asset, w, h, 1);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int mountain = h / 2 + (int)(60 * sinf(x * 0.013f) + 30 * sinf(x * 0.041f));
+            int dx = x - w * 3 / 4, dy = y - h / 4;
+            uint8_t c;
+            if (dx * dx + dy * dy < 60 * 60) c = 0xFC;
+            else if (y < mountain) c = (uint8_t)(0x03 | ((y * 8 / h) << 2));
+            else if (y < h * 3 / 4) c = 0x48 + ((x / 8 + y / 8) & 1) * 0x24;
+            else c = ((x + y / 2) / 12) & 1 ? 0x44 : 0x64;
+            row[x] = c;
+        }
+        size_t n = ra8876_rle_encode(row, w, 1, rle_asset + size, sizeof(rle_asset) - size);
+        if (n == 0) return 0;
+        size += n;
+    }
+    return size;
+}
+
+void demo21_rle_image(void) {
+    printf("Demo 21: Streaming RLE Image\n");
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    size_t size = build_rle_landscape(display.width, display.height);
+    if (size == 0) {
+        ra8876_print(&display, 10, 10, RA8876_RED, "RLE asset does not fit in buffer");
+        sleep_ms(2000);
+        return;
+    }
+
+    const int runs = 5;
+    uint32_t t0 = time_us_32();
+    bool ok = true;
+    for (int r = 0; r < runs; r++)
+        ok &= ra8876_draw_rle(&display, display.canvas_addr, 0, 0, rle_asset, size);
+    uint32_t us = (time_us_32() - t0) / runs;
+
+    float mpx = (float)display.width * display.height / 1000000.0f;
+    printf("RLE image %ux%u: %u bytes (%.1f%% of raw), %s\n", display.width, display.height,
+        size, 100.0f * size / (display.width * display.height), ok ? "ok" : "corrupt");
+    printf("Decode + upload: %lu us/frame, %.0f ms/Mpx, decoder RAM %d bytes\n", us, us / 1000.0f / mpx, RA8876_RLE_CHUNK);
+
+    ra8876_printf(&display, 10, 10, RA8876_WHITE, "RLE: %u bytes, %.0f ms/Mpx, %d B decode buffer", size, us / 1000.0f / mpx, RA8876_RLE_CHUNK);
+
+    sleep_ms(5000);
+}
+
+typedef struct {
+    float t;
+} plasma_ctx_t;
+
+static void plasma_span(void *ctx, uint16_t x, uint16_t y, uint16_t len, uint8_t *out) {
+    plasma_ctx_t *p = ctx;
+    float fy = sinf(y * 0.031f + p->t);
+    for (uint16_t i = 0; i < len; i++) {
+        float v = sinf((x + i) * 0.023f + p->t * 1.3f) + fy + sinf((x + i + y) * 0.017f);
+        uint8_t k = (uint8_t)((v + 3.0f) * 42.0f);
+        out[i] = (uint8_t)(((k >> 5) << 5) | (((k >> 3) & 0x07) << 2) | ((255 - k) >> 6));
+    }
+}
+
+void demo22_generator_write(void) {
+    printf("Demo 22: Generator BTE Write\n");
+
+    const uint16_t w = 512, h = 300;
+    plasma_ctx_t ctx = { 0.0f };
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_print(&display, 10, 10, RA8876_WHITE, "Procedural upload: frame buffer vs span producer");
+
+    uint32_t buffer_us = 0;
+    uint8_t *pixels = malloc((size_t)w * h);
+    if (pixels) {
+        uint32_t t0 = time_us_32();
+        for (uint16_t y = 0; y < h; y++)
+            plasma_span(&ctx, 0, y, w, &pixels[(size_t)y * w]);
+        ra8876_bte_write(&display, display.canvas_addr, 20, 40, w, h, pixels);
+        buffer_us = time_us_32() - t0;
+        free(pixels);
+    }
+
+    ctx.t = 1.0f;
+    uint8_t span[RA8876_BURST_SIZE];
+    uint32_t t0 = time_us_32();
+    ra8876_bte_write_begin(&display, display.canvas_addr, 20, 40, w, h);
+    for (uint16_t y = 0; y < h; y++) {
+        for (uint16_t x = 0; x < w; x += RA8876_BURST_SIZE) {
+            uint16_t len = w - x < RA8876_BURST_SIZE ? w - x : RA8876_BURST_SIZE;
+            plasma_span(&ctx, x, y, len, span);
+            ra8876_bte_write_data(&display, span, len);
+            ra8876_read_status(&display);
+        }
+    }
+    ra8876_bte_write_end(&display);
+    uint32_t serial_us = time_us_32() - t0;
+
+    ctx.t = 2.0f;
+    t0 = time_us_32();
+    ra8876_bte_write_gen(&display, display.canvas_addr, 20, 40, w, h, plasma_span, &ctx);
+    uint32_t gen_us = time_us_32() - t0;
+
+    for (int f = 0; f < 30; f++) {
+        ctx.t += 0.15f;
+        ra8876_bte_write_gen(&display, display.canvas_addr, 540, 40, 464, h, plasma_span, &ctx);
+    }
+
+    size_t staging = display.transport == &ra8876_spi_transport ? sizeof(display.burst_buf) : sizeof(display.pio_buf);
+    size_t scratch = RA8876_BURST_SIZE + staging;
+    printf("Frame buffer:  %lu us, %u bytes RAM\n", buffer_us, (unsigned)(w * h));
+    printf("Serial spans:  %lu us (bus drained after every span)\n", serial_us);
+    printf("Span producer: %lu us, %u bytes RAM (%u span + %u %s staging), %.2fx vs serial\n", gen_us,
+           (unsigned)scratch, RA8876_BURST_SIZE, (unsigned)staging, display.transport->name, (float)serial_us / gen_us);
+
+    ra8876_printf(&display, 10, 360, RA8876_WHITE, "Buffer: %lu us, %u B RAM", buffer_us, (unsigned)(w * h));
+    ra8876_printf(&display, 10, 390, RA8876_WHITE, "Serial: %lu us", serial_us);
+    ra8876_printf(&display, 10, 420, RA8876_WHITE, "Producer, %s DMA overlap: %lu us, %u B RAM (%.2fx)", display.transport->name,
+                  gen_us, (unsigned)scratch, (float)serial_us / gen_us);
+
+    sleep_ms(5000);
+}
+
+static void corpus_image(int kind, uint8_t *img, uint16_t w, uint16_t h) {
+    for (uint16_t y = 0; y < h; y++) {
+        for (uint16_t x = 0; x < w; x++) {
+            uint8_t c;
+            switch (kind) {
+                case 0:
+                    c = 0x92;
+                    if (y < 30) c = 0x03;
+                    else if (x > 20 && x < 180 && y > 60 && y < 100) c = 0x1C;
+                    else if (x > 220 && x < 380 && y > 60 && y < 100) c = 0xE0;
+                    else if (x > 20 && x < 20 + (y % 7) * 50 && y > 140 && y < 280 && (y / 20) % 2) c = 0xFC;
+                    break;
+                case 1:
+                    c = 0x00;
+                    if ((y % 20) < 14 && (x % 9) < 7 && ((x * 7 + y * 13) % 11) < 5 && (x / 9 + y / 20) % 13) c = 0xFF;
+                    break;
+                case 2:
+                    c = (uint8_t)((y * 8 / h) << 5 | (x * 8 / w) << 2);
+                    break;
+                default:
+                    c = (uint8_t)(x * 3 + y * 5 + (rand() & 0x0F));
+                    break;
+            }
+            img[(size_t)y * w + x] = c;
+        }
+    }
+}
+
+void demo23_run_upload(void) {
+    printf("Demo 23: Run-Length Aware Upload\n");
+
+    const uint16_t w = 400, h = 300;
+    const char *names[4] = { "UI panel", "Text screen", "Gradient", "Photo noise" };
+    uint8_t *img = malloc((size_t)w * h);
+    if (!img) return;
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    for (int k = 0; k < 4; k++) {
+        corpus_image(k, img, w, h);
+        uint16_t ox = (k & 1) * 512 + 20, oy = (k >> 1) * 300;
+
+        uint32_t before = display.spi_bytes;
+        uint32_t t0 = time_us_32();
+        ra8876_bte_write(&display, display.canvas_addr, ox, oy, w, h, img);
+        uint32_t raw_us = time_us_32() - t0;
+        uint32_t raw_bytes = display.spi_bytes - before;
+
+        before = display.spi_bytes;
+        t0 = time_us_32();
+        ra8876_bte_write_runs(&display, display.canvas_addr, ox, oy, w, h, img);
+        uint32_t run_us = time_us_32() - t0;
+        uint32_t run_bytes = display.spi_bytes - before;
+
+        printf("%-12s raw %6lu bytes %6lu us | runs %6lu bytes %6lu us (%.0f%%)\n",
+            names[k], raw_bytes, raw_us, run_bytes, run_us, 100.0f * run_bytes / raw_bytes);
+    }
+    free(img);
+    sleep_ms(3000);
+
+    size_t size = build_rle_landscape(display.width, display.height);
+    if (size) {
+        uint32_t before = display.spi_bytes;
+        ra8876_draw_rle(&display, display.canvas_addr, 0, 0, rle_asset, size);
+        uint32_t raw_bytes = display.spi_bytes - before;
+        before = display.spi_bytes;
+        ra8876_draw_rle_runs(&display, display.canvas_addr, 0, 0, rle_asset, size);
+        uint32_t run_bytes = display.spi_bytes - before;
+        printf("RLE asset    raw %6lu bytes | runs %6lu bytes (%.0f%%)\n", raw_bytes, run_bytes, 100.0f * run_bytes / raw_bytes);
+        ra8876_printf(&display, 10, 10, RA8876_WHITE, "RLE asset: %lu -> %lu bytes on the wire", raw_bytes, run_bytes);
+    }
+
+    sleep_ms(5000);
+}
+
+void demo24_color_convert(void) {
+    printf("Demo 24: RGB888/RGB565 to RGB332 Conversion\n");
+
+    const uint16_t w = 300, h = 160;
+    uint8_t *rgb = malloc((size_t)w * h * 3);
+    uint16_t *rgb565 = malloc((size_t)w * h * 2);
+    if (!rgb || !rgb565) {
+        free(rgb);
+        free(rgb565);
+        return;
+    }
+    for (uint16_t y = 0; y < h; y++) {
+        for (uint16_t x = 0; x < w; x++) {
+            uint8_t r = x * 255 / (w - 1), g = y * 255 / (h - 1), b = 255 - (x + y) * 255 / (w + h - 2);
+            uint8_t *p = &rgb[((size_t)y * w + x) * 3];
+            p[0] = r;
+            p[1] = g;
+            p[2] = b;
+            rgb565[(size_t)y * w + x] = ra8876_pack_rgb565(r, g, b);
+        }
+    }
+
+    static int16_t err[1024 * 3];
+    static uint8_t out[RA8876_CONV_CHUNK * 3];
+    const char *names[3] = { "none", "bayer", "floyd-steinberg" };
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_print(&display, 10, 10, RA8876_WHITE, "RGB888 -> RGB332: none / Bayer / Floyd-Steinberg (top), RGB565 (bottom)");
+
+    for (uint8_t d = 0; d < 3; d++) {
+        ra8876_conv_t c;
+        uint32_t t0 = time_us_32();
+        for (int r = 0; r < 4; r++) {
+            ra8876_conv_init(&c, w, display.bpp, d, err);
+            for (size_t i = 0; i < (size_t)w * h; i += RA8876_CONV_CHUNK)
+                ra8876_conv_rgb888(&c, &rgb[i * 3], out, (size_t)w * h - i < RA8876_CONV_CHUNK ? (size_t)w * h - i : RA8876_CONV_CHUNK);
+        }
+        float mpx888 = 4.0f * w * h / (time_us_32() - t0);
+
+        t0 = time_us_32();
+        for (int r = 0; r < 4; r++) {
+            ra8876_conv_init(&c, w, display.bpp, d, err);
+            for (size_t i = 0; i < (size_t)w * h; i += RA8876_CONV_CHUNK)
+                ra8876_conv_rgb565(&c, &rgb565[i], out, (size_t)w * h - i < RA8876_CONV_CHUNK ? (size_t)w * h - i : RA8876_CONV_CHUNK);
+        }
+        float mpx565 = 4.0f * w * h / (time_us_32() - t0);
+
+        t0 = time_us_32();
+        ra8876_bte_write_rgb888(&display, display.canvas_addr, 20 + d * 330, 60, w, h, rgb, d, err);
+        uint32_t up888 = time_us_32() - t0;
+        t0 = time_us_32();
+        ra8876_bte_write_rgb565(&display, display.canvas_addr, 20 + d * 330, 260, w, h, rgb565, d, err);
+        uint32_t up565 = time_us_32() - t0;
+
+        printf("%-16s convert 888 %.1f Mpx/s, 565 %.1f Mpx/s | fused upload 888 %lu us, 565 %lu us\n",
+            names[d], mpx888, mpx565, up888, up565);
+        ra8876_printf(&display, 20 + d * 330, 440, RA8876_WHITE, "%s", names[d]);
+        ra8876_printf(&display, 20 + d * 330, 460, RA8876_WHITE, "888 %.1f / 565 %.1f Mpx/s", mpx888, mpx565);
+        ra8876_printf(&display, 20 + d * 330, 480, RA8876_WHITE, "upload %lu / %lu us", up888, up565);
+    }
+
+    free(rgb);
+    free(rgb565);
+    sleep_ms(5000);
+}
+
+static void depth_gradient_span(void *ctx, uint16_t x, uint16_t y, uint16_t len, uint8_t *out) {
+    ra8876_t *dev = ctx;
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t r = (x + i) / 2, g = y * 255 / 299, b = 255 - (x + i) / 2;
+        out += ra8876_put_pixel(dev, out, ra8876_rgb(r, g, b));
+    }
+}
+
+void demo25_color_depth(void) {
+    printf("Demo 25: Color Depth Tradeoffs\n");
+
+    const uint8_t depths[3] = { 8, 16, 24 };
+    float fill_mpx[3], upload_kbs[3];
+    uint8_t pages[3];
+
+    for (int d = 0; d < 3; d++) {
+        ra8876_set_color_depth(&display, depths[d]);
+        ra8876_fill_screen(&display, RA8876_BLACK);
+
+        const int fills = 20;
+        uint32_t t0 = time_us_32();
+        for (int i = 0; i < fills; i++)
+            ra8876_fill_rect(&display, 0, 0, display.width, display.height, i & 1 ? RA8876_BLUE : RA8876_DARKGRAY);
+        ra8876_wait_task_busy(&display);
+        fill_mpx[d] = (float)fills * display.width * display.height / (time_us_32() - t0);
+
+        uint32_t before = display.spi_bytes;
+        t0 = time_us_32();
+        ra8876_bte_write_gen(&display, display.canvas_addr, 0, 100, 512, 300, depth_gradient_span, &display);
+        uint32_t us = time_us_32() - t0;
+        upload_kbs[d] = (display.spi_bytes - before) * 1000.0f / us;
+        pages[d] = display.max_pages;
+
+        ra8876_printf(&display, 10, 10, RA8876_WHITE, "%d bpp: fill %.1f Mpx/s, upload %.0f KB/s (%lu us for 512x300), %d pages",
+            depths[d], fill_mpx[d], upload_kbs[d], us, pages[d]);
+        printf("%2d bpp: fill %.1f Mpx/s, upload %.0f KB/s, %lu us for 512x300, %d pages\n",
+            depths[d], fill_mpx[d], upload_kbs[d], us, pages[d]);
+        sleep_ms(2000);
+    }
+
+    ra8876_set_color_depth(&display, 8);
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    for (int d = 0; d < 3; d++)
+        ra8876_printf(&display, 10, 10 + d * 30, RA8876_WHITE, "%d bpp: fill %.1f Mpx/s, upload %.0f KB/s, %d pages",
+            depths[d], fill_mpx[d], upload_kbs[d], pages[d]);
+
+    sleep_ms(5000);
+}
+
+typedef struct {
+    int16_t cx[3];
+    int16_t cy[3];
+    int16_t r;
+} tile_scene_t;
+
+static bool shaded_balls_tile(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                              uint8_t *pixels, uint16_t stride) {
+    tile_scene_t *sc = ctx;
+    const uint32_t tints[3] = { RA8876_RED, RA8876_GREEN, RA8876_CYAN };
+    bool drawn = false;
+
+    for (int b = 0; b < 3; b++) {
+        int16_t r = sc->r;
+        if (sc->cx[b] + r < x || sc->cx[b] - r >= x + w || sc->cy[b] + r < y || sc->cy[b] - r >= y + h)
+            continue;
+        for (uint16_t j = 0; j < h; j++) {
+            int dy = y + j - sc->cy[b];
+            if (dy < -r || dy > r) continue;
+            uint8_t *out = pixels + j * stride;
+            for (uint16_t i = 0; i < w; i++) {
+                int dx = x + i - sc->cx[b];
+                int d2 = dx * dx + dy * dy;
+                if (d2 > r * r) continue;
+                int lx = dx + r / 3, ly = dy + r / 3;
+                int shade = 255 - (lx * lx + ly * ly) * 255 / (4 * r * r);
+                if (shade < 40) shade = 40;
+                uint32_t t = tints[b];
+                uint32_t c = ra8876_rgb(((t >> 16) & 0xFF) * shade / 255,
+                                        ((t >> 8) & 0xFF) * shade / 255,
+                                        (t & 0xFF) * shade / 255);
+                ra8876_put_pixel(&display, out + i * ra8876_pixel_bytes(&display), c);
+                drawn = true;
+            }
+        }
+    }
+    return drawn;
+}
+
+static ra8876_tiles_t tile_layer;
+
+void demo26_tile_renderer(void) {
+    printf("Demo 26: Hybrid Tile Renderer\n");
+
+    const uint16_t ox = 64, oy = 96, ow = 640, oh = 448;
+    tile_scene_t sc = { .r = 40 };
+    float frame_us[2];
+    uint32_t frame_bytes[2];
+    uint16_t frame_tiles[2];
+
+    for (int mode = 0; mode < 2; mode++) {
+        ra8876_fill_screen(&display, RA8876_BLACK);
+        ra8876_draw_rect(&display, ox - 2, oy - 2, ow + 4, oh + 4, RA8876_WHITE);
+        ra8876_fill_rect(&display, ox, oy, ow, oh, RA8876_DARKGRAY);
+        ra8876_tiles_init(&display, &tile_layer, ox, oy, ow, oh, shaded_balls_tile, &sc);
+        ra8876_tiles_set_background(&tile_layer, RA8876_DARKGRAY, false);
+        ra8876_tiles_set_dual_core(&tile_layer, mode == 1);
+        ra8876_tiles_invalidate(&tile_layer, ox, oy, ow, oh);
+
+        const int frames = 120;
+        uint32_t total_us = 0, total_bytes = 0, total_tiles = 0;
+        for (int f = 0; f < frames; f++) {
+            for (int b = 0; b < 3; b++) {
+                float a = f * 0.05f + b * 2.094f;
+                ra8876_tiles_mark(&tile_layer, sc.cx[b] - sc.r, sc.cy[b] - sc.r, sc.r * 2 + 1, sc.r * 2 + 1);
+                sc.cx[b] = ox + ow / 2 + (int16_t)(220 * cosf(a * (1 + b * 0.3f)));
+                sc.cy[b] = oy + oh / 2 + (int16_t)(150 * sinf(a * 1.3f));
+                ra8876_tiles_mark(&tile_layer, sc.cx[b] - sc.r, sc.cy[b] - sc.r, sc.r * 2 + 1, sc.r * 2 + 1);
+            }
+
+            uint32_t before = display.spi_bytes;
+            uint32_t t0 = time_us_32();
+            ra8876_tiles_update(&display, &tile_layer, display.canvas_addr);
+            total_us += time_us_32() - t0;
+            total_bytes += display.spi_bytes - before;
+            total_tiles += tile_layer.uploaded;
+
+            ra8876_fill_rect(&display, ox + ow + 20, oy + oh - (f % 100) * 4, 40, 4, f & 1 ? RA8876_YELLOW : RA8876_ORANGE);
+            ra8876_fill_rect(&display, 0, 0, display.width, 40, RA8876_BLACK);
+            ra8876_printf(&display, 10, 10, RA8876_WHITE, "%s core: %d/%d tiles rendered, %d uploaded",
+                mode ? "dual" : "single", tile_layer.rendered, tile_layer.cols * tile_layer.rows, tile_layer.uploaded);
+        }
+        frame_us[mode] = (float)total_us / frames;
+        frame_bytes[mode] = total_bytes / frames;
+        frame_tiles[mode] = total_tiles / frames;
+
+        uint32_t before = display.spi_bytes;
+        ra8876_tiles_update(&display, &tile_layer, display.canvas_addr);
+        printf("%s core: %.0f us/frame, %lu bytes/frame, %d tiles/frame, idle update %lu bytes\n",
+            mode ? "dual" : "single", frame_us[mode], frame_bytes[mode], frame_tiles[mode],
+            display.spi_bytes - before);
+    }
+
+    ra8876_fill_rect(&display, 0, 0, display.width, 40, RA8876_BLACK);
+    ra8876_printf(&display, 10, 10, RA8876_WHITE, "single %.0f us/frame, dual %.0f us/frame, %lu bytes vs %lu full region",
+        frame_us[0], frame_us[1], frame_bytes[1], (uint32_t)ow * oh * ra8876_pixel_bytes(&display));
+
+    ra8876_tiles_set_dual_core(&tile_layer, false);
+    ra8876_tiles_set_background(&tile_layer, RA8876_MAGENTA, true);
+    for (int i = 0; i < 8; i++)
+        ra8876_fill_rect(&display, ox, oy + i * oh / 8, ow, oh / 8, i & 1 ? RA8876_BLUE : RA8876_GRAY);
+    ra8876_tiles_update(&display, &tile_layer, display.canvas_addr);
+    ra8876_printf(&display, 10, 50, RA8876_WHITE, "chroma keyed tiles over hardware fills: %d uploaded", tile_layer.uploaded);
+
+    sleep_ms(5000);
+}
+
+void demo27_antialiased(void) {
+    printf("Demo 27: Anti-aliased Lines and Circles\n");
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_draw_line(&display, display.width / 2, 40, display.width / 2, display.height - 1, RA8876_GRAY);
+
+    const int spokes = 24;
+    const float cx[2] = { 256, 768 }, cy = 300, len = 200;
+    uint32_t us[2], bytes[2];
+
+    for (int side = 0; side < 2; side++) {
+        uint32_t before = display.spi_bytes;
+        uint32_t t0 = time_us_32();
+        for (int i = 0; i < spokes; i++) {
+            float a = i * 2 * (float)M_PI / spokes + 0.07f;
+            float x1 = cx[side] + len * cosf(a), y1 = cy + len * sinf(a);
+            uint32_t color = i % 3 == 0 ? RA8876_WHITE : i % 3 == 1 ? RA8876_CYAN : RA8876_ORANGE;
+            if (side == 0)
+                ra8876_draw_line(&display, cx[side], cy, (uint16_t)(x1 + 0.5f), (uint16_t)(y1 + 0.5f), color);
+            else
+                ra8876_draw_line_aa(&display, cx[side], cy, x1, y1, 1.0f, color);
+        }
+        ra8876_wait_task_busy(&display);
+        us[side] = time_us_32() - t0;
+        bytes[side] = display.spi_bytes - before;
+
+        for (int r = 0; r < 3; r++) {
+            if (side == 0)
+                ra8876_draw_circle(&display, cx[side], cy, 60 + r * 60, RA8876_YELLOW);
+            else
+                ra8876_draw_circle_aa(&display, cx[side], cy, 60 + r * 60, 1.0f, RA8876_YELLOW);
+        }
+    }
+
+    ra8876_printf(&display, 10, 10, RA8876_WHITE, "hardware: %.0f lines/s, %lu B/line",
+        spokes * 1e6f / us[0], bytes[0] / spokes);
+    ra8876_printf(&display, display.width / 2 + 10, 10, RA8876_WHITE, "anti-aliased: %.0f lines/s, %lu B/line",
+        spokes * 1e6f / us[1], bytes[1] / spokes);
+    printf("hardware %.0f lines/s %lu B/line, aa %.0f lines/s %lu B/line\n",
+        spokes * 1e6f / us[0], bytes[0] / spokes, spokes * 1e6f / us[1], bytes[1] / spokes);
+    sleep_ms(3000);
+
+    ra8876_fill_screen(&display, RA8876_DARKGRAY);
+    for (int frame = 0; frame < 60; frame++) {
+        float v = 0.5f + 0.5f * sinf(frame * 0.1f);
+        ra8876_fill_rect(&display, 312, 100, 400, 400, RA8876_DARKGRAY);
+        ra8876_draw_arc_aa(&display, 512, 300, 180, 135, 405, 6.0f, RA8876_GRAY);
+        ra8876_draw_arc_aa(&display, 512, 300, 180, 135, 135 + 270 * v, 6.0f, RA8876_GREEN);
+        float a = (135 + 270 * v) * (float)M_PI / 180;
+        ra8876_draw_line_aa(&display, 512, 300, 512 + 150 * cosf(a), 300 + 150 * sinf(a), 3.0f, RA8876_RED);
+        ra8876_draw_circle_aa(&display, 512, 300, 12, 4.0f, RA8876_WHITE);
+    }
+    sleep_ms(2000);
+}
+
+static void transition_screen(uint8_t page, int variant) {
+    ra8876_set_canvas_page(&display, page);
+    ra8876_fill_screen(&display, variant & 1 ? RA8876_BLUE : RA8876_DARKGRAY);
+    for (int i = 0; i < 12; i++) {
+        uint32_t color = (i + variant) % 3 == 0 ? RA8876_ORANGE : (i + variant) % 3 == 1 ? RA8876_CYAN : RA8876_YELLOW;
+        ra8876_fill_circle(&display, 80 + i * 80, 300 + (int)(120 * sinf(i * 0.8f + variant)), 35, color);
+    }
+    ra8876_printf(&display, 400, 40, RA8876_WHITE, "Screen %d", variant);
+}
+
+static ra8876_transition_t transition;
+
+void demo28_transitions(void) {
+    printf("Demo 28: Page Transitions\n");
+
+    ra8876_vsync_init(&display);
+    ra8876_buffer_init(&display, 6);
+    if (display.num_pages < 6) {
+        printf("Transitions need 6 SDRAM pages, only %d available\n", display.max_pages);
+        ra8876_buffer_disable(&display);
+        return;
+    }
+    transition_screen(1, 0);
+    transition_screen(2, 1);
+    ra8876_set_display_addr(&display, ra8876_page_addr(&display, 1));
+
+    const char *names[4] = { "crossfade", "wipe", "slide", "dissolve" };
+    const uint8_t dirs[4] = { RA8876_TRANS_RIGHT, RA8876_TRANS_DOWN, RA8876_TRANS_LEFT, RA8876_TRANS_RIGHT };
+    uint8_t from = 1, to = 2;
+
+    for (int round = 0; round < 8; round++) {
+        int kind = round % 4;
+        if (!ra8876_transition_start(&display, &transition, kind, dirs[kind], from, to, 3, 4, 600))
+            break;
+
+        uint32_t t0 = time_us_32();
+        int app_draws = 0;
+        ra8876_set_canvas_page(&display, 5);
+        while (ra8876_transition_step(&display, &transition)) {
+            ra8876_fill_rect(&display, (app_draws * 13) % 1000, (app_draws * 7) % 580, 24, 20,
+                app_draws & 1 ? RA8876_GREEN : RA8876_RED);
+            app_draws++;
+        }
+        uint32_t us = time_us_32() - t0;
+        printf("%s: %d frames in %lu ms, %d app draws meanwhile\n", names[kind], transition.frames, us / 1000, app_draws);
+
+        ra8876_set_canvas_page(&display, to);
+        ra8876_printf(&display, 10, 10, RA8876_WHITE, "%s: %d frames, %d app draws", names[kind], transition.frames, app_draws);
+        transition_screen(from, round + 2);
+        sleep_ms(1000);
+        uint8_t shown = to;
+        to = from;
+        from = shown;
+    }
+
+    ra8876_buffer_disable(&display);
+}
+
+static void busy_background(void) {
+    ra8876_fill_screen(&display, RA8876_DARKGRAY);
+    for (int i = 0; i < 200; i++) {
+        uint16_t x = (i * 97) % 980, y = 40 + (i * 53) % 520;
+        uint32_t color = i % 4 == 0 ? RA8876_BLUE : i % 4 == 1 ? RA8876_GREEN : i % 4 == 2 ? RA8876_ORANGE : RA8876_CYAN;
+        if (i & 1)
+            ra8876_fill_circle(&display, x + 20, y + 20, 18, color);
+        else
+            ra8876_fill_triangle(&display, x, y + 40, x + 20, y, x + 40, y + 40, color);
+    }
+    for (int i = 0; i < 20; i++)
+        ra8876_printf(&display, 700, 60 + i * 24, RA8876_WHITE, "Background row %d", i);
+}
+
+static void draw_menu(uint16_t x, uint16_t y, uint16_t w, int items, const char *title) {
+    ra8876_fill_rect(&display, x, y, w, 30 + items * 28, RA8876_BLACK);
+    ra8876_draw_rect(&display, x, y, w, 30 + items * 28, RA8876_WHITE);
+    ra8876_print(&display, x + 10, y + 6, RA8876_YELLOW, title);
+    for (int i = 0; i < items; i++)
+        ra8876_printf(&display, x + 20, y + 34 + i * 28, RA8876_WHITE, "Item %d", i + 1);
+}
+
+static ra8876_backing_t backing;
+
+void demo29_save_under(void) {
+    printf("Demo 29: Save-under Popups\n");
+    busy_background();
+
+    uint32_t t0 = time_us_32();
+    busy_background();
+    uint32_t redraw_us = time_us_32() - t0;
+
+    if (!ra8876_backing_init(&display, &backing, 600)) {
+        printf("no SDRAM for backing store\n");
+        return;
+    }
+
+    uint32_t close_us = 0, close_bytes = 0;
+    const int cycles = 10;
+    for (int i = 0; i < cycles; i++) {
+        uint16_t mx = 100 + i * 30, my = 80 + i * 10;
+        ra8876_backing_push(&display, &backing, mx, my, 220, 30 + 6 * 28);
+        draw_menu(mx, my, 220, 6, "File");
+        ra8876_backing_push(&display, &backing, mx + 200, my + 60, 180, 30 + 4 * 28);
+        draw_menu(mx + 200, my + 60, 180, 4, "Recent");
+        sleep_ms(200);
+
+        uint32_t before = display.spi_bytes;
+        t0 = time_us_32();
+        ra8876_backing_pop(&display, &backing);
+        ra8876_backing_pop(&display, &backing);
+        close_us += time_us_32() - t0;
+        close_bytes += display.spi_bytes - before;
+        sleep_ms(100);
+    }
+
+    ra8876_backing_push(&display, &backing, 300, 200, 300, 200);
+    draw_menu(300, 200, 300, 5, "Dialog");
+    ra8876_fill_rect(&display, 250, 250, 100, 40, RA8876_RED);
+    if (!ra8876_backing_pop(&display, &backing))
+        busy_background();
+
+    ra8876_fill_rect(&display, 0, 0, display.width, 30, RA8876_BLACK);
+    ra8876_printf(&display, 10, 6, RA8876_WHITE, "close: %lu us / %lu B per menu pair, full redraw %lu us, %d invalidated",
+        close_us / cycles, close_bytes / cycles, redraw_us, backing.invalidated);
+    printf("close %lu us (%lu B), full redraw %lu us, restored %d, invalidated %d\n",
+        close_us / cycles, close_bytes / cycles, redraw_us, backing.restored, backing.invalidated);
+
+    display.backing = NULL;
+    ra8876_sdram_release(&display, backing.pool_addr);
+    sleep_ms(3000);
+}
+
+static ra8876_ui_t ui;
+static ra8876_widget_t ui_title, ui_ok, ui_cancel, ui_gauge, ui_bar, ui_list, ui_field, ui_status;
+static const char *const ui_modes[] = { "Eco", "Normal", "Sport", "Track", "Service" };
+
+void demo30_widgets(void) {
+    printf("Demo 30: Retained Widgets\n");
+    ra8876_fill_screen(&display, RA8876_BLACK);
+
+    ra8876_ui_init(&ui, RA8876_BLACK);
+    ra8876_widget_init(&ui_title, RA8876_WIDGET_LABEL, 20, 20, 400, 24, RA8876_YELLOW, RA8876_BLACK, 0);
+    ra8876_widget_init(&ui_ok, RA8876_WIDGET_BUTTON, 20, 500, 140, 44, RA8876_WHITE, RA8876_DARKGRAY, RA8876_GREEN);
+    ra8876_widget_init(&ui_cancel, RA8876_WIDGET_BUTTON, 180, 500, 140, 44, RA8876_WHITE, RA8876_DARKGRAY, RA8876_RED);
+    ra8876_widget_init(&ui_gauge, RA8876_WIDGET_GAUGE, 40, 80, 320, 200, RA8876_WHITE, RA8876_BLACK, RA8876_ORANGE);
+    ra8876_widget_init(&ui_bar, RA8876_WIDGET_BAR, 40, 320, 600, 36, RA8876_WHITE, RA8876_BLACK, RA8876_CYAN);
+    ra8876_widget_init(&ui_list, RA8876_WIDGET_LIST, 700, 80, 260, 5 * 24 + 2, RA8876_WHITE, RA8876_BLACK, RA8876_BLUE);
+    ra8876_widget_init(&ui_field, RA8876_WIDGET_FIELD, 40, 400, 400, 32, RA8876_WHITE, RA8876_BLACK, RA8876_YELLOW);
+    ra8876_widget_init(&ui_status, RA8876_WIDGET_LABEL, 500, 560, 500, 24, RA8876_GRAY, RA8876_BLACK, 0);
+
+    ra8876_widget_set_text(&ui_title, "Retained widgets");
+    ra8876_widget_set_text(&ui_ok, "OK");
+    ra8876_widget_set_text(&ui_cancel, "Cancel");
+    ra8876_widget_set_range(&ui_gauge, 0, 8000);
+    ra8876_widget_set_range(&ui_bar, 0, 1000);
+    ra8876_widget_set_items(&ui_list, ui_modes, 5);
+
+    ra8876_widget_t *all[] = { &ui_title, &ui_ok, &ui_cancel, &ui_gauge, &ui_bar, &ui_list, &ui_field, &ui_status };
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++)
+        ra8876_ui_add(&ui, all[i]);
+
+    const char *typed = "Hello RA8876";
+    uint32_t total = 0, idle = 0;
+    const int frames = 600;
+    char buf[32];
+
+    for (int f = 0; f < frames; f++) {
+        if (f < 300) {
+            ra8876_widget_set_value(&ui_gauge, (int16_t)(4000 + 3500 * sinf(f * 0.03f)) / 100 * 100);
+            ra8876_widget_set_value(&ui_bar, (f * 7) % 1000 / 10 * 10);
+        }
+        ra8876_widget_select(&ui_list, (f / 60) % 5);
+        size_t n = (size_t)(f / 20) < strlen(typed) ? (size_t)(f / 20) : strlen(typed);
+        memcpy(buf, typed, n);
+        buf[n] = 0;
+        ra8876_widget_set_text(&ui_field, buf);
+        ra8876_widget_set_pressed(&ui_ok, (f / 45) % 4 == 1);
+
+        uint32_t before = display.spi_bytes;
+        ra8876_ui_update(&display, &ui);
+        uint32_t used = display.spi_bytes - before;
+        total += used;
+        if (used == 0) idle++;
+        ra8876_wait_vsync(&display);
+    }
+
+    uint32_t before = display.spi_bytes;
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++)
+        ra8876_ui_damage(&ui, all[i]->rect.x, all[i]->rect.y, all[i]->rect.w, all[i]->rect.h);
+    ra8876_ui_update(&display, &ui);
+    uint32_t full = display.spi_bytes - before;
+
+    snprintf(buf, sizeof(buf), "%lu B/frame, %lu idle", total / frames, idle);
+    ra8876_widget_set_text(&ui_status, buf);
+    ra8876_ui_update(&display, &ui);
+    printf("widgets: %lu B/frame avg, %lu/%d idle frames, full repaint %lu B\n", total / frames, idle, frames, full);
+    sleep_ms(3000);
+}
+
+void demo31_clipping(void) {
+    printf("Demo 31: Clip Stack\n");
+    ra8876_fill_screen(&display, RA8876_BLACK);
+
+    const int16_t wx = 162, wy = 100, ww = 700, wh = 400;
+    ra8876_draw_rect(&display, wx - 1, wy - 1, ww + 2, wh + 2, RA8876_WHITE);
+    ra8876_print(&display, wx, wy - 24, RA8876_WHITE, "Clipped viewport");
+
+    uint32_t t0 = time_us_32();
+    uint32_t bytes0 = display.spi_bytes;
+    uint32_t sub0 = display.ops_submitted, cull0 = display.ops_culled, trim0 = display.ops_trimmed;
+
+    for (int f = 0; f < 240; f++) {
+        ra8876_clip_push(&display, wx, wy, ww, wh);
+        ra8876_fill_rect(&display, wx, wy, ww, wh, ra8876_rgb(10, 20, 40));
+
+        int32_t ox = wx + (f * 6) % (ww + 400) - 200;
+        for (int i = 0; i < 12; i++) {
+            int32_t cx = ox + i * 90 - 500, cy = wy + 60 + (i % 4) * 90;
+            ra8876_fill_circle_s(&display, cx, cy, 40, ra8876_rgb(40 + i * 16, 200 - i * 12, 120));
+            ra8876_fill_rect_s(&display, cx - 20, cy + 45, 80, 12, RA8876_YELLOW);
+            ra8876_draw_line_s(&display, cx - 300, cy - 300, cx + 300, cy + 300, RA8876_CYAN);
+        }
+        ra8876_fill_triangle_s(&display, ox - 150, wy + wh - 10, ox + 150, wy + wh - 10, ox, wy + wh + 200, RA8876_MAGENTA);
+
+        ra8876_clip_push(&display, wx + ww / 2 - 80, wy + wh / 2 - 50, 160, 100);
+        ra8876_fill_rounded_rect_s(&display, wx + ww / 2 - 120 + (f % 80), wy + wh / 2 - 60, 200, 120, 24, RA8876_ORANGE);
+        ra8876_clip_pop(&display);
+
+        ra8876_clip_pop(&display);
+        ra8876_wait_vsync(&display);
+    }
+
+    uint32_t elapsed = time_us_32() - t0;
+    uint32_t sub = display.ops_submitted - sub0, cull = display.ops_culled - cull0, trim = display.ops_trimmed - trim0;
+    ra8876_printf(&display, 20, 540, RA8876_GREEN, "submitted %lu  trimmed %lu  culled %lu  %lu B/frame  %lu us/frame",
+                  sub, trim, cull, (display.spi_bytes - bytes0) / 240, elapsed / 240);
+    printf("clip: submitted %lu trimmed %lu culled %lu, %lu B/frame\n", sub, trim, cull, (display.spi_bytes - bytes0) / 240);
+    sleep_ms(3000);
+}
+
+#define PANEL_BENCH_FILLS 400
+#define PANEL_BENCH_LINES 200
+
+typedef struct {
+    ra8876_t *devs[2];
+    uint8_t count;
+    bool text;
+    uint32_t pixels;
+    uint32_t chars;
+} panel_job_t;
+
+static void panel_bench(void *arg) {
+    static const char line[] = "The quick brown fox jumps over the lazy dog 0123456789";
+    panel_job_t *job = arg;
+    uint32_t seed = 12345;
+    int runs = job->text ? PANEL_BENCH_LINES : PANEL_BENCH_FILLS;
+
+    for (int i = 0; i < runs; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        uint32_t color = ra8876_rgb(seed >> 24, seed >> 16, seed >> 8);
+        for (uint8_t d = 0; d < job->count; d++) {
+            ra8876_t *dev = job->devs[d];
+            if (job->text) {
+                ra8876_print(dev, 8 + (i & 7) * 8, 40 + (i % 34) * 16, color | 0x404040, line);
+                job->chars += sizeof(line) - 1;
+            } else {
+                uint16_t x = (seed >> 8) % (dev->width - 200);
+                uint16_t y = 40 + (seed >> 16) % (dev->height - 190);
+                ra8876_bte_solid_fill(dev, dev->canvas_addr, x, y, 200, 150, color);
+                job->pixels += 200 * 150;
+            }
+        }
+    }
+    for (uint8_t d = 0; d < job->count; d++)
+        ra8876_wait_task_busy(job->devs[d]);
+}
+
+static void panel_clear(ra8876_t *const *panels) {
+    for (int d = 0; d < 2; d++) {
+        ra8876_set_canvas_page(panels[d], 0);
+        ra8876_fill_screen(panels[d], RA8876_BLACK);
+    }
+}
+
+void demo32_dual_panel(void) {
+    printf("Demo 32: Dual Panel\n");
+    if (!display2_ok) {
+        printf("Second panel not found, skipping\n");
+        return;
+    }
+
+    ra8876_t *panels[2] = { &display, &display2 };
+    static const char *modes[3] = { "1 panel", "2 panels, 1 core", "2 panels, 2 cores" };
+    uint32_t rate[2][3];
+    ra8876_core1_start();
+
+    for (int text = 0; text < 2; text++) {
+        for (int mode = 0; mode < 3; mode++) {
+            panel_clear(panels);
+            panel_job_t a = { { &display, &display2 }, mode == 1 ? 2 : 1, text, 0, 0 };
+            panel_job_t b = { { &display2 }, 1, text, 0, 0 };
+
+            uint32_t t0 = time_us_32();
+            if (mode == 2) ra8876_core1_run(panel_bench, &b);
+            panel_bench(&a);
+            if (mode == 2) ra8876_core1_wait();
+            uint32_t us = time_us_32() - t0;
+
+            uint32_t work = text ? a.chars + (mode == 2 ? b.chars : 0) : a.pixels + (mode == 2 ? b.pixels : 0);
+            rate[text][mode] = (uint32_t)((uint64_t)work * (text ? 1000000 : 1000) / us);
+            printf("%s %s: %lu %s\n", text ? "Text" : "Fill", modes[mode], rate[text][mode], text ? "chars/s" : "kpx/s");
+        }
+    }
+
+    panel_clear(panels);
+    for (int d = 0; d < 2; d++) {
+        ra8876_printf(panels[d], 20, 20, RA8876_WHITE, "Panel %d of 2", d + 1);
+        for (int mode = 0; mode < 3; mode++)
+            ra8876_printf(panels[d], 20, 60 + mode * 24, RA8876_YELLOW, "%-18s fill %6lu kpx/s  text %6lu chars/s",
+                          modes[mode], rate[0][mode], rate[1][mode]);
+    }
+    sleep_ms(4000);
+
+    ra8876_buffer_init(&display, 2);
+    ra8876_buffer_init(&display2, 2);
+    uint32_t skew_sum = 0, skew_max = 0;
+    int span = display.width + display2.width;
+    for (int f = 0; f < 240; f++) {
+        int bx = (f * 12) % span;
+        for (int d = 0; d < 2; d++) {
+            ra8876_t *dev = panels[d];
+            uint32_t addr = ra8876_page_addr(dev, ra8876_get_draw_page(dev));
+            ra8876_bte_solid_fill(dev, addr, 0, 0, dev->width, dev->height, ra8876_rgb(0, 0, 40));
+            ra8876_bte_solid_fill_s(dev, addr, bx - d * display.width, 100, 120, 400, RA8876_YELLOW);
+            ra8876_bte_solid_fill_s(dev, addr, bx - d * display.width - span, 100, 120, 400, RA8876_YELLOW);
+        }
+        uint32_t skew = ra8876_swap_buffers_group(panels, 2);
+        skew_sum += skew;
+        if (skew > skew_max) skew_max = skew;
+    }
+    ra8876_buffer_disable(&display);
+    ra8876_buffer_disable(&display2);
+
+    printf("Group swap skew: avg %lu us, max %lu us\n", skew_sum / 240, skew_max);
+    printf("Dual panel demo complete\n");
+}
+
+#define REG_BENCH_WRITES 20000
+
+static uint32_t reg_bench(ra8876_t *dev, bool *ok) {
+    ra8876_wait_task_busy(dev);
+    uint32_t t0 = time_us_32();
+    for (int i = 0; i < REG_BENCH_WRITES; i++)
+        ra8876_write_reg(dev, RA8876_DT_X, i);
+    ra8876_read_status(dev);
+    uint32_t us = time_us_32() - t0;
+
+    *ok = true;
+    for (int i = 0; i < 64; i++) {
+        ra8876_write_reg(dev, RA8876_DT_X, i * 4 + 1);
+        if (ra8876_read_reg(dev, RA8876_DT_X) != i * 4 + 1) *ok = false;
+    }
+    return (uint32_t)((uint64_t)REG_BENCH_WRITES * 1000000 / us);
+}
+
+void demo33_pio_spi(void) {
+    printf("Demo 33: PIO SPI Transport\n");
+
+    static const uint32_t speeds[] = { 20000000, 40000000, 60000000 };
+    char line[96];
+    bool ok;
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_print(&display, 20, 20, RA8876_WHITE, "Register writes/sec, hardware SPI vs PIO SPI");
+
+    const ra8876_transport_t *home = display.transport;
+    if (home != &ra8876_spi_transport) {
+        printf("PIO SPI demo needs the panel on the SPI bus\n");
+        return;
+    }
+
+    uint32_t base = reg_bench(&display, &ok);
+    snprintf(line, sizeof(line), "SPI %2lu MHz: %7lu writes/s %s", display.spi_speed / 1000000, base, ok ? "" : "readback FAILED");
+    printf("%s\n", line);
+    ra8876_print(&display, 20, 60, RA8876_YELLOW, line);
+
+    for (int i = 0; i < (int)(sizeof(speeds) / sizeof(speeds[0])); i++) {
+        display.pio_speed = speeds[i];
+        if (!ra8876_set_transport(&display, &ra8876_pio_spi_transport)) {
+            printf("PIO transport unavailable\n");
+            break;
+        }
+        uint32_t rate = reg_bench(&display, &ok);
+        uint32_t mhz = display.pio_speed / 1000000;
+        ra8876_set_transport(&display, home);
+
+        snprintf(line, sizeof(line), "PIO %2lu MHz: %7lu writes/s  x%lu.%02lu %s", mhz, rate,
+                 rate / base, rate * 100 / base % 100, ok ? "" : "readback FAILED");
+        printf("%s\n", line);
+        ra8876_print(&display, 20, 90 + i * 30, ok ? RA8876_GREEN : RA8876_RED, line);
+    }
+
+    sleep_ms(3000);
+    printf("PIO SPI demo complete\n");
+}
+
+static uint32_t frame_upload_us(ra8876_t *dev, const uint8_t *row) {
+    uint16_t stride = dev->width * (dev->bpp / 8);
+    ra8876_wait_task_busy(dev);
+    uint32_t t0 = time_us_32();
+    ra8876_bte_write_begin(dev, dev->canvas_addr, 0, 0, dev->width, dev->height);
+    for (uint16_t y = 0; y < dev->height; y++)
+        ra8876_bte_write_data(dev, row + (y & 63) * 3 * (dev->bpp / 8), stride);
+    ra8876_bte_write_end(dev);
+    ra8876_wait_task_busy(dev);
+    return time_us_32() - t0;
+}
+
+void demo34_transports(void) {
+    printf("Demo 34: Bus Transports\n");
+
+    static uint8_t row[(1024 + 192) * 3];
+    const ra8876_transport_t *home = display.transport;
+    const ra8876_transport_t *list[3] = { home, 0, 0 };
+    int count = 1;
+    char lines[3][64];
+    int done = 0;
+
+    if (home == &ra8876_spi_transport) list[count++] = &ra8876_pio_spi_transport;
+
+    uint8_t *out = row;
+    for (int x = 0; x < display.width + 192; x++)
+        out += ra8876_put_pixel(&display, out, ra8876_rgb(x * 3, 255 - x, x * 7));
+
+    uint32_t frame_bytes = (uint32_t)display.width * display.height * (display.bpp / 8);
+    for (int i = 0; i < count; i++) {
+        if (list[i] != home) {
+            display.pio_speed = 40000000;
+            if (!ra8876_set_transport(&display, list[i])) {
+                printf("%s transport unavailable\n", list[i]->name);
+                continue;
+            }
+        }
+        uint32_t us = frame_upload_us(&display, row);
+        if (list[i] != home) ra8876_set_transport(&display, home);
+
+        snprintf(lines[done], sizeof(lines[done]), "%-8s %5lu.%lu ms/frame %3lu.%02lu MB/s", list[i]->name,
+                 us / 1000, us / 100 % 10, frame_bytes / us, (uint32_t)((uint64_t)frame_bytes * 100 / us % 100));
+        printf("%s\n", lines[done++]);
+    }
+
+    ra8876_fill_rect(&display, 10, 10, 500, 30 + done * 30, RA8876_BLACK);
+    for (int i = 0; i < done; i++)
+        ra8876_print(&display, 20, 20 + i * 30, RA8876_WHITE, lines[i]);
+
+    sleep_ms(3000);
+    printf("Transport demo complete\n");
+}
+
+#define STREAM_BENCH_OPS 500
+
+static uint32_t stream_bench(bool triangles) {
+    ra8876_wait_task_busy(&display);
+    uint32_t t0 = time_us_32();
+    for (int i = 0; i < STREAM_BENCH_OPS; i++) {
+        uint16_t x = 40 + (i * 37) % 900, y = 200 + (i * 53) % 360;
+        if (triangles)
+            ra8876_fill_triangle(&display, x, y, x + 20, y + 5, x + 8, y + 24, ra8876_rgb(i * 5, 255 - i, 128));
+        else
+            ra8876_bte_copy(&display, display.canvas_addr, x, y, display.canvas_addr, 1000 - x, y, 8, 8, RA8876_ROP_S);
+    }
+    ra8876_wait_task_busy(&display);
+    return (time_us_32() - t0) * 100 / STREAM_BENCH_OPS;
+}
+
+void demo35_command_streams(void) {
+    printf("Demo 35: Register Command Streams\n");
+
+    const ra8876_transport_t *home = display.transport;
+    const ra8876_transport_t *list[2] = { home, &ra8876_pio_spi_transport };
+    int count = home == &ra8876_spi_transport ? 2 : 1;
+    char line[96];
+
+    ra8876_fill_screen(&display, RA8876_BLACK);
+    ra8876_print(&display, 20, 20, RA8876_WHITE, "us per op, one transfer per register vs one stream per op");
+
+    for (int i = 0; i < count; i++) {
+        if (list[i] != home && !ra8876_set_transport(&display, list[i])) continue;
+        uint32_t us[2][2];
+        for (int mode = 0; mode < 2; mode++) {
+            ra8876_set_streaming(&display, mode == 1);
+            us[mode][0] = stream_bench(false);
+            us[mode][1] = stream_bench(true);
+        }
+        ra8876_set_streaming(&display, true);
+        if (list[i] != home) ra8876_set_transport(&display, home);
+
+        for (int k = 0; k < 2; k++) {
+            snprintf(line, sizeof(line), "%-8s %-9s %3lu.%02lu -> %3lu.%02lu us  (-%lu%%)", list[i]->name,
+                     k ? "triangle" : "bte copy", us[0][k] / 100, us[0][k] % 100, us[1][k] / 100, us[1][k] % 100,
+                     us[0][k] > us[1][k] ? (us[0][k] - us[1][k]) * 100 / us[0][k] : 0);
+            printf("%s\n", line);
+            ra8876_fill_rect(&display, 10, 50 + (i * 2 + k) * 30, 600, 24, RA8876_BLACK);
+            ra8876_print(&display, 20, 50 + (i * 2 + k) * 30, RA8876_YELLOW, line);
+        }
+    }
+
+    sleep_ms(3000);
+    printf("Command stream demo complete\n");
+}
+
+static const uint8_t bayer4[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+static int8_t pattern_handles[24];
+
+void demo36_pattern_cache(void) {
+    printf("Demo 36: Pattern Cache\n");
+
+    static ra8876_pattern_cache_t cache;
+    static bool ready;
+    if (!ready) {
+        if (!ra8876_pattern_cache_init(&display, &cache, 24)) {
+            printf("Pattern cache: no SDRAM left\n");
+            return;
+        }
+        uint8_t bits[32];
+        for (int level = 0; level <= 16; level++) {
+            for (int y = 0; y < 8; y++) {
+                bits[y] = 0;
+                for (int x = 0; x < 8; x++)
+                    if (bayer4[y & 3][x & 3] < level) bits[y] |= 0x80 >> x;
+            }
+            pattern_handles[level] = ra8876_pattern_add_mono(&display, &cache, bits, 8, RA8876_CYAN, RA8876_BLUE);
+        }
+        static const uint8_t hatches[4][8] = {
+            { 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00 },
+            { 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88 },
+            { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 },
+            { 0xFF, 0x88, 0x88, 0x88, 0xFF, 0x88, 0x88, 0x88 },
+        };
+        for (int i = 0; i < 4; i++)
+            pattern_handles[17 + i] = ra8876_pattern_add_mono(&display, &cache, hatches[i], 8, RA8876_YELLOW, RA8876_BLACK);
+        for (int y = 0; y < 16; y++) {
+            bits[y * 2] = y < 8 ? 0xFF : 0x00;
+            bits[y * 2 + 1] = y < 8 ? 0x00 : 0xFF;
+        }
+        pattern_handles[21] = ra8876_pattern_add_mono(&display, &cache, bits, 16, RA8876_GRAY, RA8876_BLACK);
+        ready = true;
+    }
+
+    uint32_t t0 = time_us_32();
+    ra8876_pattern_fill(&display, &cache, pattern_handles[21], display.canvas_addr, 0, 0,
+                        display.width, display.height, RA8876_ROP_S);
+    ra8876_wait_task_busy(&display);
+    uint32_t full_us = time_us_32() - t0;
+
+    int band_w = (display.width - 40) / 17;
+    t0 = time_us_32();
+    for (int level = 0; level <= 16; level++)
+        ra8876_pattern_fill(&display, &cache, pattern_handles[level], display.canvas_addr,
+                            20 + level * band_w, 80, band_w, 200, RA8876_ROP_S);
+    ra8876_wait_task_busy(&display);
+    uint32_t band_us = time_us_32() - t0;
+
+    for (int i = 0; i < 4; i++) {
+        ra8876_fill_rect(&display, 40 + i * 240, 340, 200, 200, RA8876_RED);
+        ra8876_pattern_fill(&display, &cache, pattern_handles[17 + i], display.canvas_addr,
+                            40 + i * 240, 340, 200, 200, RA8876_ROP_S_OR_D);
+    }
+
+    char line[96];
+    snprintf(line, sizeof(line), "%u patterns cached, full screen fill %lu us, 17 dither bands %lu us",
+             cache.used, full_us, band_us);
+    printf("%s\n", line);
+    ra8876_fill_rect(&display, 10, 20, 760, 30, RA8876_BLACK);
+    ra8876_print(&display, 20, 26, RA8876_WHITE, line);
+
+    sleep_ms(3000);
+    printf("Pattern cache demo complete\n");
+}
+
+static void sky_span(void *ctx, uint16_t x, uint16_t y, uint16_t len, uint8_t *out) {
+    (void)x;
+    uint32_t color = ra8876_rgb(20 + y * 200 / 299, 40 + y * 120 / 299, 160 - y * 140 / 299);
+    for (uint16_t i = 0; i < len; i++)
+        out += ra8876_put_pixel(&display, out, color);
+}
+
+void demo37_gradients(void) {
+    printf("Demo 37: Gradient Fills\n");
+    ra8876_fill_screen(&display, RA8876_BLACK);
+
+    static ra8876_pattern_cache_t dither;
+    static bool ready;
+    if (!ready) ready = ra8876_pattern_cache_init(&display, &dither, 4);
+
+    uint32_t c0 = ra8876_rgb(20, 40, 160), c1 = ra8876_rgb(220, 160, 20);
+
+    uint32_t before = display.spi_bytes;
+    uint32_t t0 = time_us_32();
+    ra8876_bte_write_gen(&display, display.canvas_addr, 20, 60, 300, 300, sky_span, NULL);
+    uint32_t soft_us = time_us_32() - t0;
+    uint32_t soft_bytes = display.spi_bytes - before;
+
+    before = display.spi_bytes;
+    t0 = time_us_32();
+    ra8876_gradient_rect(&display, 340, 60, 300, 300, c0, c1, true, NULL);
+    ra8876_wait_task_busy(&display);
+    uint32_t hard_us = time_us_32() - t0;
+    uint32_t hard_bytes = display.spi_bytes - before;
+
+    before = display.spi_bytes;
+    t0 = time_us_32();
+    ra8876_gradient_rect(&display, 660, 60, 300, 300, c0, c1, true, ready ? &dither : NULL);
+    ra8876_wait_task_busy(&display);
+    uint32_t dither_us = time_us_32() - t0;
+    uint32_t dither_bytes = display.spi_bytes - before;
+
+    ra8876_gradient_rect(&display, 20, 380, 300, 60, RA8876_BLACK, RA8876_WHITE, false, ready ? &dither : NULL);
+    ra8876_gradient_rounded_rect(&display, 20, 460, 300, 120, 30, RA8876_RED, RA8876_BLUE, false, NULL);
+    ra8876_gradient_rounded_rect(&display, 340, 380, 300, 200, 40, RA8876_CYAN, RA8876_MAGENTA, true,
+                                 ready ? &dither : NULL);
+    ra8876_gradient_radial(&display, 810, 480, 150, 100, RA8876_YELLOW, ra8876_rgb(80, 0, 0));
+
+    char line[128];
+    snprintf(line, sizeof(line), "upload %lu us %lu B, bands %lu us %lu B, dithered %lu us %lu B",
+             soft_us, soft_bytes, hard_us, hard_bytes, dither_us, dither_bytes);
+    printf("%s\n", line);
+    ra8876_print(&display, 20, 20, RA8876_WHITE, line);
+
+    sleep_ms(3000);
+}
+
 int main() {
     stdio_init_all();
     sleep_ms(1000);
@@ -1445,6 +3045,17 @@ int main() {
     }
 
     printf("Chip ID: 0x%02X\n", ra8876_get_chip_id(&display));
+    uint32_t hz = ra8876_spi_calibrate(&display, 75000000, true);
+    if (hz) printf("SPI clock: %lu Hz\n", hz);
+    else printf("SPI calibration failed, staying at %lu Hz\n", display.spi_speed);
+
+    display2_ok = ra8876_init(&display2, 1024, 600);
+    printf("Second panel: %s\n", display2_ok ? "found" : "not found");
+    if (display2_ok) {
+        hz = ra8876_spi_calibrate(&display2, 75000000, true);
+        if (hz) printf("Second panel SPI clock: %lu Hz\n", hz);
+        else printf("Second panel SPI calibration failed, staying at %lu Hz\n", display2.spi_speed);
+    }
 
     while (1) {
         demo1_shapes();
@@ -1462,5 +3073,27 @@ int main() {
         demo13_blend_write_pip();
         demo14_text_transparency();
         demo15_cgram_inv();
+        demo16_text_batch_bench();
+        demo17_hud_fields();
+        demo18_polyline();
+        demo19_strip_chart();
+        demo20_polygon_fill();
+        demo21_rle_image();
+        demo22_generator_write();
+        demo23_run_upload();
+        demo24_color_convert();
+        demo25_color_depth();
+        demo26_tile_renderer();
+        demo27_antialiased();
+        demo28_transitions();
+        demo29_save_under();
+        demo30_widgets();
+        demo31_clipping();
+        demo32_dual_panel();
+        demo33_pio_spi();
+        demo34_transports();
+        demo35_command_streams();
+        demo36_pattern_cache();
+        demo37_gradients();
     }
 }
@@ -2,7 +2,20 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
+#include <math.h>
 #include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+
+static bool core1_running;
 
 static inline void cs_select(ra8876_t *dev) {
     asm volatile("nop \n nop \n nop");
@@ -16,68 +29,475 @@ static inline void cs_deselect(ra8876_t *dev) {
     asm volatile("nop \n nop \n nop");
 }
 
-uint8_t ra8876_read_status(ra8876_t *dev) {
-    uint8_t cmd = 0x40;
-    uint8_t status = 0;
+static void spi_finish(ra8876_t *dev) {
+    if (!dev->dma_busy) return;
+    dma_channel_wait_for_finish_blocking(dev->dma_chan);
+    while (spi_is_busy(dev->spi))
+        tight_loop_contents();
+    cs_deselect(dev);
+    while (spi_is_readable(dev->spi))
+        (void)spi_get_hw(dev->spi)->dr;
+    spi_get_hw(dev->spi)->icr = SPI_SSPICR_RORIC_BITS;
+    dev->dma_busy = false;
+}
+
+static ra8876_t *spi_owner[2];
+
+static void spi_acquire(ra8876_t *dev) {
+    ra8876_t **owner = &spi_owner[spi_get_index(dev->spi)];
+    if (*owner) spi_finish(*owner);
+    if (*owner != dev) spi_set_baudrate(dev->spi, dev->spi_speed);
+    *owner = dev;
+}
+
+static bool spi_open(ra8876_t *dev) {
+    spi_acquire(dev);
+    spi_init(dev->spi, dev->spi_speed);
+    spi_set_format(dev->spi, 8, SPI_CPOL_1, SPI_CPHA_1, SPI_MSB_FIRST);
+    gpio_set_function(dev->pin_miso, GPIO_FUNC_SPI);
+    gpio_set_function(dev->pin_sck, GPIO_FUNC_SPI);
+    gpio_set_function(dev->pin_mosi, GPIO_FUNC_SPI);
+    gpio_init(dev->pin_cs);
+    gpio_set_dir(dev->pin_cs, GPIO_OUT);
+    gpio_put(dev->pin_cs, 1);
+
+    dev->dma_busy = false;
+    dev->dma_chan = dma_claim_unused_channel(false);
+    if (dev->dma_chan >= 0) {
+        dma_channel_config c = dma_channel_get_default_config(dev->dma_chan);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+        channel_config_set_dreq(&c, spi_get_dreq(dev->spi, true));
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, false);
+        dma_channel_configure(dev->dma_chan, &c, &spi_get_hw(dev->spi)->dr, NULL, 0, false);
+    }
+    return true;
+}
+
+static void spi_close(ra8876_t *dev) {
+    spi_finish(dev);
+    if (spi_owner[spi_get_index(dev->spi)] == dev) spi_owner[spi_get_index(dev->spi)] = NULL;
+    if (dev->dma_chan >= 0) dma_channel_unclaim(dev->dma_chan);
+    dev->dma_chan = -1;
+}
+
+static void spi_write(ra8876_t *dev, uint8_t cycle, const uint8_t *data, size_t len) {
+    spi_acquire(dev);
+    dev->burst_buf[0] = cycle;
+    memcpy(&dev->burst_buf[1], data, len);
     cs_select(dev);
-    spi_write_blocking(dev->spi, &cmd, 1);
-    spi_read_blocking(dev->spi, 0, &status, 1);
+    if (len >= 8 && dev->dma_chan >= 0) {
+        dma_channel_transfer_from_buffer_now(dev->dma_chan, dev->burst_buf, len + 1);
+        dev->dma_busy = true;
+        return;
+    }
+    spi_write_blocking(dev->spi, dev->burst_buf, len + 1);
     cs_deselect(dev);
-    return status;
 }
 
-void ra8876_write_cmd(ra8876_t *dev, ra8876_reg_t reg) {
-    uint8_t buf[2] = {0x00, reg};
+static void spi_write_frames(ra8876_t *dev, const uint16_t *frames, size_t count) {
+    spi_hw_t *hw = spi_get_hw(dev->spi);
+    spi_acquire(dev);
+    for (size_t i = 0; i < count; i++) {
+        cs_select(dev);
+        hw->dr = frames[i] >> 8;
+        hw->dr = frames[i] & 0xFF;
+        while (spi_is_busy(dev->spi))
+            tight_loop_contents();
+        cs_deselect(dev);
+    }
+    while (spi_is_readable(dev->spi))
+        (void)hw->dr;
+    hw->icr = SPI_SSPICR_RORIC_BITS;
+}
+
+static uint8_t spi_read(ra8876_t *dev, uint8_t cycle) {
+    uint8_t tx[2] = {cycle, 0x00};
+    uint8_t rx[2];
+    spi_acquire(dev);
     cs_select(dev);
-    spi_write_blocking(dev->spi, buf, 2);
+    spi_write_read_blocking(dev->spi, tx, rx, 2);
     cs_deselect(dev);
+    return rx[1];
+}
+
+const ra8876_transport_t ra8876_spi_transport = {
+    .name = "SPI",
+    .open = spi_open,
+    .close = spi_close,
+    .write = spi_write,
+    .read = spi_read,
+    .write_frames = spi_write_frames,
+};
+
+static uint16_t pio_spi_insn[10];
+static const pio_program_t pio_spi_program = { .instructions = pio_spi_insn, .length = 10, .origin = -1 };
+static uint16_t pio_8080_insn[22];
+static const pio_program_t pio_8080_program = { .instructions = pio_8080_insn, .length = 22, .origin = -1 };
+
+static void pio_spi_build(uint16_t *insn) {
+    insn[0] = pio_encode_pull(false, true) | pio_encode_sideset(2, 3);
+    insn[1] = pio_encode_out(pio_x, 8) | pio_encode_sideset(2, 3) | pio_encode_delay(1);
+    insn[2] = pio_encode_out(pio_y, 8) | pio_encode_sideset(2, 2) | pio_encode_delay(1);
+    insn[3] = pio_encode_out(pio_pins, 1) | pio_encode_sideset(2, 0);
+    insn[4] = pio_encode_jmp_x_dec(3) | pio_encode_sideset(2, 2);
+    insn[5] = pio_encode_jmp_not_y(0) | pio_encode_sideset(2, 2);
+    insn[6] = pio_encode_jmp_y_dec(7) | pio_encode_sideset(2, 2);
+    insn[7] = pio_encode_nop() | pio_encode_sideset(2, 0) | pio_encode_delay(3);
+    insn[8] = pio_encode_in(pio_pins, 1) | pio_encode_sideset(2, 2) | pio_encode_delay(3);
+    insn[9] = pio_encode_jmp_y_dec(7) | pio_encode_sideset(2, 2);
+}
+
+static void pio_8080_build(uint16_t *insn) {
+    insn[0] = pio_encode_pull(false, true) | pio_encode_sideset(2, 3);
+    insn[1] = pio_encode_out(pio_pins, 8) | pio_encode_sideset(2, 3);
+    insn[2] = pio_encode_out(pio_x, 1) | pio_encode_sideset(2, 3);
+    insn[3] = pio_encode_jmp_not_x(6) | pio_encode_sideset(2, 3);
+    insn[4] = pio_encode_set(pio_pins, 1) | pio_encode_sideset(2, 3);
+    insn[5] = pio_encode_jmp(7) | pio_encode_sideset(2, 3);
+    insn[6] = pio_encode_set(pio_pins, 0) | pio_encode_sideset(2, 3);
+    insn[7] = pio_encode_out(pio_x, 1) | pio_encode_sideset(2, 3);
+    insn[8] = pio_encode_jmp_x_dec(18) | pio_encode_sideset(2, 3);
+    insn[9] = pio_encode_out(pio_y, 8) | pio_encode_sideset(2, 3);
+    insn[10] = pio_encode_out(pio_null, 14) | pio_encode_sideset(2, 3);
+    insn[11] = pio_encode_nop() | pio_encode_sideset(2, 2) | pio_encode_delay(1);
+    insn[12] = pio_encode_jmp_y_dec(14) | pio_encode_sideset(2, 3) | pio_encode_delay(1);
+    insn[13] = pio_encode_jmp(0) | pio_encode_sideset(2, 3);
+    insn[14] = pio_encode_out(pio_pins, 8) | pio_encode_sideset(2, 3);
+    insn[15] = pio_encode_nop() | pio_encode_sideset(2, 2) | pio_encode_delay(1);
+    insn[16] = pio_encode_jmp_y_dec(14) | pio_encode_sideset(2, 3);
+    insn[17] = pio_encode_jmp(0) | pio_encode_sideset(2, 3);
+    insn[18] = pio_encode_out(pio_pindirs, 8) | pio_encode_sideset(2, 3);
+    insn[19] = pio_encode_nop() | pio_encode_sideset(2, 1) | pio_encode_delay(7);
+    insn[20] = pio_encode_in(pio_pins, 8) | pio_encode_sideset(2, 1);
+    insn[21] = pio_encode_out(pio_pindirs, 8) | pio_encode_sideset(2, 3);
+}
+
+static bool pio_claim(ra8876_t *dev, const pio_program_t *program, uint32_t cycles, bool shift_right,
+                      pio_sm_config *c) {
+    PIO pio = dev->pio ? dev->pio : pio0;
+    unsigned sm, offset;
+    if (!pio_claim_free_sm_and_add_program(program, &pio, &sm, &offset)) return false;
+
+    uint32_t speed = dev->pio_speed ? dev->pio_speed : dev->spi_speed;
+    float div = (float)clock_get_hz(clk_sys) / ((float)cycles * speed);
+    *c = pio_get_default_sm_config();
+    sm_config_set_wrap(c, offset, offset + program->length - 1);
+    sm_config_set_sideset(c, 2, false, false);
+    sm_config_set_out_shift(c, shift_right, true, 32);
+    sm_config_set_in_shift(c, false, true, 8);
+    sm_config_set_clkdiv(c, div < 1.0f ? 1.0f : div);
+
+    dev->pio = pio;
+    dev->pio_sm = sm;
+    dev->pio_offset = offset;
+
+    dev->pio_dma = dma_claim_unused_channel(false);
+    if (dev->pio_dma >= 0) {
+        dma_channel_config d = dma_channel_get_default_config(dev->pio_dma);
+        channel_config_set_transfer_data_size(&d, DMA_SIZE_32);
+        channel_config_set_bswap(&d, !shift_right);
+        channel_config_set_dreq(&d, pio_get_dreq(pio, sm, true));
+        channel_config_set_read_increment(&d, true);
+        channel_config_set_write_increment(&d, false);
+        dma_channel_configure(dev->pio_dma, &d, &pio->txf[sm], NULL, 0, false);
+    }
+    return true;
+}
+
+static void pio_release(ra8876_t *dev, const pio_program_t *program) {
+    if (dev->pio_dma >= 0) {
+        dma_channel_wait_for_finish_blocking(dev->pio_dma);
+        dma_channel_unclaim(dev->pio_dma);
+    }
+    dev->pio_dma = -1;
+    pio_sm_set_enabled(dev->pio, dev->pio_sm, false);
+    pio_remove_program_and_unclaim_sm(program, dev->pio, dev->pio_sm, dev->pio_offset);
+}
+
+static void pio_wait_dma(ra8876_t *dev) {
+    if (dev->pio_dma >= 0)
+        dma_channel_wait_for_finish_blocking(dev->pio_dma);
+}
+
+static bool pio_spi_open(ra8876_t *dev) {
+    if (dev->pin_sck != dev->pin_cs + 1) {
+        printf("RA8876: PIO SPI needs pin_sck == pin_cs + 1\n");
+        return false;
+    }
+    pio_spi_build(pio_spi_insn);
+    pio_sm_config c;
+    if (!pio_claim(dev, &pio_spi_program, 2, false, &c)) return false;
+    sm_config_set_sideset_pins(&c, dev->pin_cs);
+    sm_config_set_out_pins(&c, dev->pin_mosi, 1);
+    sm_config_set_in_pins(&c, dev->pin_miso);
+
+    uint32_t outs = (1u << dev->pin_cs) | (1u << dev->pin_sck) | (1u << dev->pin_mosi);
+    pio_sm_set_pins_with_mask(dev->pio, dev->pio_sm, (1u << dev->pin_cs) | (1u << dev->pin_sck), outs);
+    pio_sm_set_pindirs_with_mask(dev->pio, dev->pio_sm, outs, outs | (1u << dev->pin_miso));
+    pio_gpio_init(dev->pio, dev->pin_cs);
+    pio_gpio_init(dev->pio, dev->pin_sck);
+    pio_gpio_init(dev->pio, dev->pin_mosi);
+    pio_gpio_init(dev->pio, dev->pin_miso);
+    pio_sm_init(dev->pio, dev->pio_sm, dev->pio_offset, &c);
+    pio_sm_set_enabled(dev->pio, dev->pio_sm, true);
+    return true;
+}
+
+static void pio_spi_close(ra8876_t *dev) {
+    pio_release(dev, &pio_spi_program);
+}
+
+static void pio_spi_write(ra8876_t *dev, uint8_t cycle, const uint8_t *data, size_t len) {
+    pio_wait_dma(dev);
+    if (len >= 8 && dev->pio_dma >= 0) {
+        uint8_t *b = (uint8_t *)dev->pio_buf;
+        b[0] = (len + 1) * 8 - 1;
+        b[1] = 0;
+        b[2] = cycle;
+        memcpy(&b[3], data, len);
+        dma_channel_transfer_from_buffer_now(dev->pio_dma, dev->pio_buf, (len + 3 + 3) / 4);
+        return;
+    }
+    uint32_t word = ((uint32_t)((len + 1) * 8 - 1) << 24) | ((uint32_t)cycle << 8);
+    int shift = 0;
+    for (size_t i = 0; i < len; i++) {
+        word |= (uint32_t)data[i] << shift;
+        shift -= 8;
+        if (shift < 0) {
+            pio_sm_put_blocking(dev->pio, dev->pio_sm, word);
+            word = 0;
+            shift = 24;
+        }
+    }
+    if (shift != 24) pio_sm_put_blocking(dev->pio, dev->pio_sm, word);
+}
+
+static void pio_spi_write_frames(ra8876_t *dev, const uint16_t *frames, size_t count) {
+    pio_wait_dma(dev);
+    if (count >= 4 && dev->pio_dma >= 0) {
+        uint8_t *b = (uint8_t *)dev->pio_buf;
+        for (size_t i = 0; i < count; i++, b += 4) {
+            b[0] = 15;
+            b[1] = 0;
+            b[2] = frames[i] >> 8;
+            b[3] = frames[i] & 0xFF;
+        }
+        dma_channel_transfer_from_buffer_now(dev->pio_dma, dev->pio_buf, count);
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+        pio_sm_put_blocking(dev->pio, dev->pio_sm, (15u << 24) | frames[i]);
+}
+
+static uint8_t pio_spi_read(ra8876_t *dev, uint8_t cycle) {
+    pio_wait_dma(dev);
+    pio_sm_put_blocking(dev->pio, dev->pio_sm, (7u << 24) | (8u << 16) | ((uint32_t)cycle << 8));
+    return pio_sm_get_blocking(dev->pio, dev->pio_sm) & 0xFF;
+}
+
+const ra8876_transport_t ra8876_pio_spi_transport = {
+    .name = "PIO SPI",
+    .open = pio_spi_open,
+    .close = pio_spi_close,
+    .write = pio_spi_write,
+    .read = pio_spi_read,
+    .write_frames = pio_spi_write_frames,
+};
+
+static bool pio_8080_open(ra8876_t *dev) {
+    pio_8080_build(pio_8080_insn);
+    pio_sm_config c;
+    if (!pio_claim(dev, &pio_8080_program, 4, true, &c)) return false;
+    sm_config_set_sideset_pins(&c, dev->pin_wr);
+    sm_config_set_out_pins(&c, dev->pin_data, 8);
+    sm_config_set_set_pins(&c, dev->pin_data + 8, 1);
+    sm_config_set_in_pins(&c, dev->pin_data);
+
+    uint32_t bus = 0x1FFu << dev->pin_data;
+    uint32_t strobes = 3u << dev->pin_wr;
+    pio_sm_set_pins_with_mask(dev->pio, dev->pio_sm, strobes, bus | strobes);
+    pio_sm_set_pindirs_with_mask(dev->pio, dev->pio_sm, bus | strobes, bus | strobes);
+    for (int i = 0; i < 9; i++)
+        pio_gpio_init(dev->pio, dev->pin_data + i);
+    pio_gpio_init(dev->pio, dev->pin_wr);
+    pio_gpio_init(dev->pio, dev->pin_wr + 1);
+    gpio_init(dev->pin_cs);
+    gpio_set_dir(dev->pin_cs, GPIO_OUT);
+    gpio_put(dev->pin_cs, 0);
+    pio_sm_init(dev->pio, dev->pio_sm, dev->pio_offset, &c);
+    pio_sm_set_enabled(dev->pio, dev->pio_sm, true);
+    return true;
+}
+
+static void pio_8080_close(ra8876_t *dev) {
+    pio_release(dev, &pio_8080_program);
+    gpio_put(dev->pin_cs, 1);
+}
+
+static void pio_8080_write(ra8876_t *dev, uint8_t cycle, const uint8_t *data, size_t len) {
+    uint32_t word = data[0] | ((uint32_t)(cycle >> 7) << 8) | ((uint32_t)(len - 1) << 10);
+    pio_wait_dma(dev);
+    if (len >= 8 && dev->pio_dma >= 0) {
+        dev->pio_buf[0] = word;
+        memcpy(&dev->pio_buf[1], &data[1], len - 1);
+        dma_channel_transfer_from_buffer_now(dev->pio_dma, dev->pio_buf, 1 + (len - 1 + 3) / 4);
+        return;
+    }
+    pio_sm_put_blocking(dev->pio, dev->pio_sm, word);
+    for (size_t i = 1; i < len; i += 4) {
+        word = 0;
+        for (size_t j = 0; j < 4 && i + j < len; j++)
+            word |= (uint32_t)data[i + j] << (j * 8);
+        pio_sm_put_blocking(dev->pio, dev->pio_sm, word);
+    }
+}
+
+static void pio_8080_write_frames(ra8876_t *dev, const uint16_t *frames, size_t count) {
+    pio_wait_dma(dev);
+    bool dma = count >= 4 && dev->pio_dma >= 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t word = (frames[i] & 0xFF) | ((uint32_t)(frames[i] >> 15) << 8);
+        if (dma)
+            dev->pio_buf[i] = word;
+        else
+            pio_sm_put_blocking(dev->pio, dev->pio_sm, word);
+    }
+    if (dma) dma_channel_transfer_from_buffer_now(dev->pio_dma, dev->pio_buf, count);
+}
+
+static uint8_t pio_8080_read(ra8876_t *dev, uint8_t cycle) {
+    pio_wait_dma(dev);
+    pio_sm_put_blocking(dev->pio, dev->pio_sm, ((uint32_t)(cycle >> 7) << 8) | (1u << 9) | (0xFFu << 18));
+    return pio_sm_get_blocking(dev->pio, dev->pio_sm) & 0xFF;
+}
+
+const ra8876_transport_t ra8876_pio_8080_transport = {
+    .name = "PIO 8080",
+    .open = pio_8080_open,
+    .close = pio_8080_close,
+    .write = pio_8080_write,
+    .read = pio_8080_read,
+    .write_frames = pio_8080_write_frames,
+};
+
+bool ra8876_set_transport(ra8876_t *dev, const ra8876_transport_t *transport) {
+    const ra8876_transport_t *old = dev->transport;
+    if (old == transport) return true;
+    if (old) {
+        ra8876_wait_task_busy(dev);
+        ra8876_read_status(dev);
+        old->close(dev);
+    }
+    dev->transport = transport;
+    if (transport->open(dev)) return true;
+    dev->transport = old;
+    if (old) old->open(dev);
+    return false;
+}
+
+static void stream_flush(ra8876_t *dev) {
+    size_t count = dev->stream_len;
+    if (!count) return;
+    dev->stream_len = 0;
+    if (dev->transport->write_frames) {
+        dev->transport->write_frames(dev, dev->stream, count);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint8_t d = dev->stream[i] & 0xFF;
+        dev->transport->write(dev, dev->stream[i] >> 8, &d, 1);
+    }
+}
+
+static void bus_write(ra8876_t *dev, uint8_t cycle, const uint8_t *data, size_t len) {
+    stream_flush(dev);
+    dev->transport->write(dev, cycle, data, len);
+    dev->spi_bytes += len + 1;
+}
+
+static uint8_t bus_read(ra8876_t *dev, uint8_t cycle) {
+    stream_flush(dev);
+    dev->spi_bytes += 2;
+    return dev->transport->read(dev, cycle);
+}
+
+static inline void bus_frame(ra8876_t *dev, uint8_t cycle, uint8_t d) {
+    if (!dev->stream_depth || dev->stream_off) {
+        bus_write(dev, cycle, &d, 1);
+        return;
+    }
+    dev->stream[dev->stream_len++] = ((uint16_t)cycle << 8) | d;
+    dev->spi_bytes += 2;
+    if (dev->stream_len == RA8876_STREAM_MAX) stream_flush(dev);
+}
+
+static inline void stream_begin(ra8876_t *dev) {
+    dev->stream_depth++;
+}
+
+static inline void stream_end(ra8876_t *dev) {
+    if (--dev->stream_depth == 0) stream_flush(dev);
+}
+
+void ra8876_set_streaming(ra8876_t *dev, bool enable) {
+    stream_flush(dev);
+    dev->stream_off = !enable;
+}
+
+static void link_fault(ra8876_t *dev) {
+    dev->link_errors++;
+    if (!dev->spi_floor || dev->transport != &ra8876_spi_transport || dev->spi_speed <= dev->spi_floor) return;
+    uint32_t hz = dev->spi_speed - RA8876_SPI_CAL_STEP;
+    if (hz < dev->spi_floor) hz = dev->spi_floor;
+    dev->spi_speed = spi_set_baudrate(dev->spi, hz);
+}
+
+static inline bool status_invalid(uint8_t s) {
+    return (s & 0xC0) == 0xC0 || (s & 0x30) == 0x30;
+}
+
+uint8_t ra8876_read_status(ra8876_t *dev) {
+    uint8_t s = bus_read(dev, RA8876_CYCLE_STATUS);
+    if (status_invalid(s)) {
+        link_fault(dev);
+        s = bus_read(dev, RA8876_CYCLE_STATUS);
+    }
+    return s;
+}
+
+void ra8876_write_cmd(ra8876_t *dev, ra8876_reg_t reg) {
+    uint8_t r = reg;
+    bus_write(dev, RA8876_CYCLE_CMD, &r, 1);
 }
 
 void ra8876_write_data(ra8876_t *dev, uint8_t data) {
     while (ra8876_read_status(dev) & 0x80);
-    uint8_t buf[2] = {0x80, data};
-    cs_select(dev);
-    spi_write_blocking(dev->spi, buf, 2);
-    cs_deselect(dev);
+    bus_write(dev, RA8876_CYCLE_DATA, &data, 1);
 }
 
 void ra8876_write_data_burst(ra8876_t *dev, const uint8_t *data, size_t len) {
-    dev->burst_buf[0] = 0x80;
     size_t offset = 0;
     while (offset < len) {
         while ((ra8876_read_status(dev) & 0x40) == 0)
             tight_loop_contents();
         size_t chunk = len - offset;
         if (chunk > RA8876_BURST_SIZE) chunk = RA8876_BURST_SIZE;
-        memcpy(&dev->burst_buf[1], &data[offset], chunk);
-        cs_select(dev);
-        spi_write_blocking(dev->spi, dev->burst_buf, chunk + 1);
-        cs_deselect(dev);
+        bus_write(dev, RA8876_CYCLE_DATA, &data[offset], chunk);
         offset += chunk;
     }
 }
 
 uint8_t ra8876_read_data(ra8876_t *dev) {
-    uint8_t tx[2] = {0xC0, 0x00};
-    uint8_t rx[2];
-    cs_select(dev);
-    spi_write_read_blocking(dev->spi, tx, rx, 2);
-    cs_deselect(dev);
-    return rx[1];
+    return bus_read(dev, RA8876_CYCLE_READ);
 }
 
 static inline void cmd(ra8876_t *dev, ra8876_reg_t reg) {
-    uint8_t buf[2] = {0x00, (uint8_t)reg};
-    cs_select(dev);
-    spi_write_blocking(dev->spi, buf, 2);
-    cs_deselect(dev);
+    bus_frame(dev, RA8876_CYCLE_CMD, reg);
 }
 
 static inline void dat(ra8876_t *dev, uint8_t d) {
-    uint8_t buf[2] = {0x80, d};
-    cs_select(dev);
-    spi_write_blocking(dev->spi, buf, 2);
-    cs_deselect(dev);
+    bus_frame(dev, RA8876_CYCLE_DATA, d);
 }
 
 static inline void reg_wr(ra8876_t *dev, ra8876_reg_t reg, uint8_t val) {
@@ -91,10 +511,12 @@ static inline void reg_wr16(ra8876_t *dev, ra8876_reg_t reg, uint16_t val) {
 }
 
 static inline void reg_wr32(ra8876_t *dev, ra8876_reg_t reg, uint32_t val) {
+    stream_begin(dev);
     reg_wr(dev, reg, val & 0xFF);
     reg_wr(dev, (ra8876_reg_t)(reg + 1), (val >> 8) & 0xFF);
     reg_wr(dev, (ra8876_reg_t)(reg + 2), (val >> 16) & 0xFF);
     reg_wr(dev, (ra8876_reg_t)(reg + 3), (val >> 24) & 0xFF);
+    stream_end(dev);
 }
 
 void ra8876_write_reg(ra8876_t *dev, ra8876_reg_t reg, uint8_t val) {
@@ -128,31 +550,99 @@ void ra8876_wait_task_busy(ra8876_t *dev) {
 }
 
 static void set_draw_color(ra8876_t *dev, uint32_t color) {
+    if (color == dev->fg_color) return;
+    dev->fg_color = color;
+    stream_begin(dev);
     reg_wr(dev, RA8876_FGCR, (color >> 16) & 0xFF);
     reg_wr(dev, RA8876_FGCG, (color >> 8) & 0xFF);
     reg_wr(dev, RA8876_FGCB, color & 0xFF);
+    stream_end(dev);
 }
 
 static void set_bg_draw_color(ra8876_t *dev, uint32_t color) {
+    if (color == dev->bg_color) return;
+    dev->bg_color = color;
+    stream_begin(dev);
     reg_wr(dev, RA8876_BGCR, (color >> 16) & 0xFF);
     reg_wr(dev, RA8876_BGCG, (color >> 8) & 0xFF);
     reg_wr(dev, RA8876_BGCB, color & 0xFF);
+    stream_end(dev);
+}
+
+static uint8_t point_reg_cost(ra8876_t *dev, uint8_t idx, uint16_t val) {
+    if (!(dev->pt_valid & (1 << idx))) return 2;
+    uint16_t diff = dev->pt_regs[idx] ^ val;
+    return ((diff & 0x00FF) != 0) + ((diff & 0xFF00) != 0);
+}
+
+static void set_point_reg(ra8876_t *dev, uint8_t idx, uint16_t val) {
+    ra8876_reg_t reg = (ra8876_reg_t)(RA8876_DLHSR + idx * 2);
+    bool valid = dev->pt_valid & (1 << idx);
+    uint16_t diff = dev->pt_regs[idx] ^ val;
+    if (!valid || (diff & 0x00FF)) reg_wr(dev, reg, val & 0xFF);
+    if (!valid || (diff & 0xFF00)) reg_wr(dev, (ra8876_reg_t)(reg + 1), val >> 8);
+    dev->pt_regs[idx] = val;
+    dev->pt_valid |= 1 << idx;
 }
 
 static void set_two_points(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
-    reg_wr16(dev, RA8876_DLHSR, x0);
-    reg_wr16(dev, RA8876_DLVSR, y0);
-    reg_wr16(dev, RA8876_DLHER, x1);
-    reg_wr16(dev, RA8876_DLVER, y1);
+    stream_begin(dev);
+    set_point_reg(dev, 0, x0);
+    set_point_reg(dev, 1, y0);
+    set_point_reg(dev, 2, x1);
+    set_point_reg(dev, 3, y1);
+    stream_end(dev);
 }
 
 static void set_three_points(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
-    reg_wr16(dev, RA8876_DLHSR, x0);
-    reg_wr16(dev, RA8876_DLVSR, y0);
-    reg_wr16(dev, RA8876_DLHER, x1);
-    reg_wr16(dev, RA8876_DLVER, y1);
-    reg_wr16(dev, RA8876_DTPH, x2);
-    reg_wr16(dev, RA8876_DTPV, y2);
+    stream_begin(dev);
+    set_point_reg(dev, 0, x0);
+    set_point_reg(dev, 1, y0);
+    set_point_reg(dev, 2, x1);
+    set_point_reg(dev, 3, y1);
+    set_point_reg(dev, 4, x2);
+    set_point_reg(dev, 5, y2);
+    stream_end(dev);
+}
+
+static void set_line_points(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    uint8_t fwd = point_reg_cost(dev, 0, x0) + point_reg_cost(dev, 1, y0) +
+                  point_reg_cost(dev, 2, x1) + point_reg_cost(dev, 3, y1);
+    uint8_t rev = point_reg_cost(dev, 0, x1) + point_reg_cost(dev, 1, y1) +
+                  point_reg_cost(dev, 2, x0) + point_reg_cost(dev, 3, y0);
+    if (rev < fwd)
+        set_two_points(dev, x1, y1, x0, y0);
+    else
+        set_two_points(dev, x0, y0, x1, y1);
+}
+
+static void set_triangle_points(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+    static const uint8_t perms[6][3] = { {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0} };
+    const uint16_t vx[3] = { x0, x1, x2 };
+    const uint16_t vy[3] = { y0, y1, y2 };
+    uint8_t best = 0, best_cost = 0xFF;
+    for (uint8_t p = 0; p < 6 && best_cost > 0; p++) {
+        uint8_t cost = 0;
+        for (uint8_t k = 0; k < 3; k++)
+            cost += point_reg_cost(dev, k * 2, vx[perms[p][k]]) + point_reg_cost(dev, k * 2 + 1, vy[perms[p][k]]);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = p;
+        }
+    }
+    const uint8_t *o = perms[best];
+    set_three_points(dev, vx[o[0]], vy[o[0]], vx[o[1]], vy[o[1]], vx[o[2]], vy[o[2]]);
+}
+
+static inline void touch(ra8876_t *dev, uint32_t addr, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (dev->backing) ra8876_backing_damage(dev->backing, addr, x, y, w, h);
+}
+
+static void touch_span(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    if (!dev->backing) return;
+    int32_t lx = x0 < x1 ? x0 : x1, ly = y0 < y1 ? y0 : y1;
+    int32_t hx = x0 < x1 ? x1 : x0, hy = y0 < y1 ? y1 : y0;
+    ra8876_backing_damage(dev->backing, dev->canvas_addr, lx, ly, hx - lx + 1, hy - ly + 1);
 }
 
 static void draw_and_wait(ra8876_t *dev, ra8876_reg_t reg, uint8_t val) {
@@ -160,6 +650,15 @@ static void draw_and_wait(ra8876_t *dev, ra8876_reg_t reg, uint8_t val) {
     ra8876_wait_task_busy(dev);
 }
 
+static uint8_t depth_code(uint8_t bpp) {
+    return bpp == 24 ? 2 : bpp == 16 ? 1 : 0;
+}
+
+static uint32_t cgram_addr(ra8876_t *dev) {
+    (void)dev;
+    return RA8876_SDRAM_SIZE - 65536;
+}
+
 static void soft_reset(ra8876_t *dev) {
     reg_wr(dev, RA8876_SRR, 0x01);
     sleep_ms(100);
@@ -221,16 +720,18 @@ static void init_display(ra8876_t *dev) {
     reg_wr(dev, RA8876_VSTR, 11);
     reg_wr(dev, RA8876_VPWR, 9);
 
-    dev->reg10 = 0x00;
+    dev->reg10 = depth_code(dev->bpp) << 2;
     reg_wr(dev, RA8876_MPWCTR, dev->reg10);
-    reg_wr(dev, RA8876_PIPCDEP, 0x00);
+    dev->reg11 = (depth_code(dev->bpp) << 2) | depth_code(dev->bpp);
+    reg_wr(dev, RA8876_PIPCDEP, dev->reg11);
 
     reg_wr32(dev, RA8876_MISA, 0);
     reg_wr16(dev, RA8876_MIW, dev->width);
     reg_wr16(dev, RA8876_MWULX, 0);
     reg_wr16(dev, RA8876_MWULY, 0);
 
-    reg_wr(dev, RA8876_AW_COLOR, 0x00);
+    dev->reg5E = depth_code(dev->bpp);
+    reg_wr(dev, RA8876_AW_COLOR, dev->reg5E);
 
     reg_wr32(dev, RA8876_CVSSA, 0);
     reg_wr16(dev, RA8876_CVS_IMWTH, dev->width);
@@ -238,7 +739,10 @@ static void init_display(ra8876_t *dev) {
     reg_wr16(dev, RA8876_AWUL_Y, 0);
     reg_wr16(dev, RA8876_AW_WTH, dev->width);
     reg_wr16(dev, RA8876_AW_HT, dev->height);
-
+    dev->aw_x = 0;
+    dev->aw_y = 0;
+    dev->aw_w = dev->width;
+    dev->aw_h = dev->height;
 }
 
 static void init_pwm(ra8876_t *dev) {
@@ -277,8 +781,11 @@ void ra8876_wake_standby(ra8876_t *dev) {
 bool ra8876_init(ra8876_t *dev, uint16_t width, uint16_t height) {
     dev->width = width;
     dev->height = height;
-    dev->page_size = (uint32_t)width * height;
-    dev->max_pages = RA8876_SDRAM_SIZE / dev->page_size;
+    if (dev->bpp != 16 && dev->bpp != 24) dev->bpp = 8;
+    dev->page_size = (uint32_t)width * height * ra8876_pixel_bytes(dev);
+    dev->sdram_top = cgram_addr(dev);
+    dev->sdram_blocks = 0;
+    dev->max_pages = dev->sdram_top / dev->page_size;
 
     dev->char_width = 8;
     dev->char_height = 16;
@@ -293,15 +800,37 @@ bool ra8876_init(ra8876_t *dev, uint16_t width, uint16_t height) {
     dev->reg3C = 0x00;
     dev->regCC = 0x00;
     dev->regCD = 0x00;
-
-    spi_init(dev->spi, dev->spi_speed);
-    spi_set_format(dev->spi, 8, SPI_CPOL_1, SPI_CPHA_1, SPI_MSB_FIRST);
-    gpio_set_function(dev->pin_miso, GPIO_FUNC_SPI);
-    gpio_set_function(dev->pin_sck, GPIO_FUNC_SPI);
-    gpio_set_function(dev->pin_mosi, GPIO_FUNC_SPI);
-    gpio_init(dev->pin_cs);
-    gpio_set_dir(dev->pin_cs, GPIO_OUT);
-    gpio_put(dev->pin_cs, 1);
+    dev->regD0 = 0x00;
+    dev->regD1 = 0x00;
+    dev->fg_color = 0xFFFFFFFF;
+    dev->bg_color = 0xFFFFFFFF;
+    dev->text_x = RA8876_UNKNOWN_POS;
+    dev->text_y = RA8876_UNKNOWN_POS;
+    dev->text_batch = 0;
+    dev->text_stale = false;
+    dev->spi_bytes = 0;
+    dev->pt_valid = 0;
+    dev->dma_chan = -1;
+    dev->dma_busy = false;
+    dev->pio_dma = -1;
+    dev->stream_len = 0;
+    dev->stream_depth = 0;
+    dev->aa_addr = RA8876_SDRAM_NONE;
+    dev->backing = NULL;
+    dev->ops_submitted = 0;
+    dev->ops_culled = 0;
+    dev->ops_trimmed = 0;
+    dev->batch_w = 0;
+    dev->batch_pos = false;
+    dev->wr_clip = false;
+    ra8876_clip_reset(dev);
+    dev->reg92 = (depth_code(dev->bpp) << 5) | (depth_code(dev->bpp) << 2) | depth_code(dev->bpp);
+
+    if (!dev->transport) dev->transport = &ra8876_spi_transport;
+    if (!dev->transport->open(dev)) {
+        printf("RA8876: %s transport open failed\n", dev->transport->name);
+        return false;
+    }
 
     sleep_ms(100);
 
@@ -333,733 +862,4047 @@ bool ra8876_init(ra8876_t *dev, uint16_t width, uint16_t height) {
     return true;
 }
 
-void ra8876_fill_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t color) {
-    set_two_points(dev, x, y, x + w - 1, y + h - 1);
-    set_draw_color(dev, color);
-    draw_and_wait(dev, RA8876_DCR1, 0xE0);
+typedef struct {
+    uint32_t magic;
+    uint32_t key;
+    uint32_t hz;
+    uint32_t crc;
+} spi_cal_record_t;
+
+#define SPI_CAL_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define SPI_CAL_SLOTS  (FLASH_PAGE_SIZE / sizeof(spi_cal_record_t))
+
+static uint32_t crc32_bytes(const void *data, size_t len) {
+    const uint8_t *p = data;
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++)
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+    return ~crc;
 }
 
-void ra8876_draw_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t color) {
-    set_two_points(dev, x, y, x + w - 1, y + h - 1);
-    set_draw_color(dev, color);
-    draw_and_wait(dev, RA8876_DCR1, 0xA0);
+static bool spi_cal_valid(const spi_cal_record_t *rec) {
+    return rec->magic == RA8876_SPI_CAL_MAGIC && rec->crc == crc32_bytes(rec, offsetof(spi_cal_record_t, crc));
 }
 
-void ra8876_draw_line(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
-    set_two_points(dev, x0, y0, x1, y1);
-    set_draw_color(dev, color);
-    draw_and_wait(dev, RA8876_DCR0, 0x80);
+static uint32_t spi_cal_key(ra8876_t *dev) {
+    return ((uint32_t)spi_get_index(dev->spi) << 8) | dev->pin_cs;
 }
 
-static void draw_ellipse(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint32_t color, uint8_t cmd) {
-    reg_wr16(dev, RA8876_DEHR, x);
-    reg_wr16(dev, RA8876_DEVR, y);
-    reg_wr16(dev, RA8876_ELL_A, rx);
-    reg_wr16(dev, RA8876_ELL_B, ry);
-    set_draw_color(dev, color);
-    draw_and_wait(dev, RA8876_DCR1, cmd);
+static const spi_cal_record_t *spi_cal_find(ra8876_t *dev) {
+    const spi_cal_record_t *rec = (const spi_cal_record_t *)(XIP_BASE + SPI_CAL_OFFSET);
+    for (size_t i = 0; i < SPI_CAL_SLOTS; i++)
+        if (spi_cal_valid(&rec[i]) && rec[i].key == spi_cal_key(dev)) return &rec[i];
+    return NULL;
 }
 
-void ra8876_fill_circle(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t r, uint32_t color) {
-    draw_ellipse(dev, x, y, r, r, color, 0xC0);
+bool ra8876_spi_save(ra8876_t *dev) {
+    if (core1_running || dev->transport != &ra8876_spi_transport) return false;
+    const spi_cal_record_t *old = spi_cal_find(dev);
+    if (old && old->hz == dev->spi_speed) return true;
+
+    static spi_cal_record_t page[SPI_CAL_SLOTS];
+    const spi_cal_record_t *rec = (const spi_cal_record_t *)(XIP_BASE + SPI_CAL_OFFSET);
+    uint32_t key = spi_cal_key(dev);
+    size_t n = 0;
+    memset(page, 0xFF, sizeof(page));
+    for (size_t i = 0; i < SPI_CAL_SLOTS && n < SPI_CAL_SLOTS - 1; i++)
+        if (spi_cal_valid(&rec[i]) && rec[i].key != key) page[n++] = rec[i];
+    page[n].magic = RA8876_SPI_CAL_MAGIC;
+    page[n].key = key;
+    page[n].hz = dev->spi_speed;
+    page[n].crc = crc32_bytes(&page[n], offsetof(spi_cal_record_t, crc));
+
+    spi_finish(dev);
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_erase(SPI_CAL_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(SPI_CAL_OFFSET, (const uint8_t *)page, FLASH_PAGE_SIZE);
+    restore_interrupts(irq);
+
+    old = spi_cal_find(dev);
+    return old && old->hz == dev->spi_speed;
 }
 
-void ra8876_draw_circle(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t r, uint32_t color) {
-    draw_ellipse(dev, x, y, r, r, color, 0x80);
+static bool status_wait(ra8876_t *dev, uint8_t mask, uint8_t want) {
+    for (int i = 0; i < 1000; i++)
+        if ((ra8876_read_status(dev) & mask) == want) return true;
+    return false;
 }
 
-void ra8876_fill_ellipse(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint32_t color) {
-    draw_ellipse(dev, x, y, rx, ry, color, 0xC0);
-}
+static bool link_test(ra8876_t *dev, uint32_t addr, uint32_t seed) {
+    uint8_t pattern[RA8876_SPI_CAL_BYTES], back[RA8876_SPI_CAL_BYTES];
+    uint32_t errors = dev->link_errors, speed = dev->spi_speed;
+    for (int i = 0; i < RA8876_SPI_CAL_BYTES; i++) {
+        seed = seed * 1664525 + 1013904223;
+        pattern[i] = (seed >> 24) ^ (i & 1 ? 0xAA : 0x55);
+    }
 
-void ra8876_draw_ellipse(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint32_t color) {
-    draw_ellipse(dev, x, y, rx, ry, color, 0x80);
+    bool ok = true;
+    for (int i = 0; i < 8; i++)
+        reg_wr(dev, (ra8876_reg_t)(RA8876_DLHSR + i), pattern[i] & (i & 1 ? 0x1F : 0xFF));
+    for (int i = 0; i < 8; i++)
+        if (ra8876_read_reg(dev, (ra8876_reg_t)(RA8876_DLHSR + i)) != (pattern[i] & (i & 1 ? 0x1F : 0xFF))) ok = false;
+    dev->pt_valid = 0;
+
+    if (ok && addr != RA8876_SDRAM_NONE) {
+        ok = status_wait(dev, 0x08, 0x00);
+        reg_wr(dev, RA8876_AW_COLOR, 0x04);
+        reg_wr32(dev, RA8876_CURH, addr);
+        cmd(dev, RA8876_MRWDP);
+        for (int i = 0; ok && i < RA8876_SPI_CAL_BYTES; i += RA8876_BURST_SIZE) {
+            int chunk = RA8876_SPI_CAL_BYTES - i < RA8876_BURST_SIZE ? RA8876_SPI_CAL_BYTES - i : RA8876_BURST_SIZE;
+            ok = status_wait(dev, 0x40, 0x40);
+            bus_write(dev, RA8876_CYCLE_DATA, &pattern[i], chunk);
+        }
+        ok = ok && status_wait(dev, 0x40, 0x40);
+
+        reg_wr32(dev, RA8876_CURH, addr);
+        cmd(dev, RA8876_MRWDP);
+        ra8876_read_data(dev);
+        for (int i = 0; ok && i < RA8876_SPI_CAL_BYTES; i++) {
+            ok = status_wait(dev, 0x10, 0x00);
+            back[i] = ra8876_read_data(dev);
+        }
+        reg_wr(dev, RA8876_AW_COLOR, dev->reg5E);
+        cmd(dev, RA8876_CHIP_ID);
+        ok = ok && memcmp(pattern, back, sizeof(pattern)) == 0;
+    }
+    return ok && dev->link_errors == errors && dev->spi_speed == speed;
 }
 
-void ra8876_fill_rounded_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t r, uint32_t color) {
-    set_two_points(dev, x, y, x + w - 1, y + h - 1);
-    reg_wr16(dev, RA8876_ELL_A, r);
-    reg_wr16(dev, RA8876_ELL_B, r);
-    set_draw_color(dev, color);
-    draw_and_wait(dev, RA8876_DCR1, 0xF0);
+static bool link_passes(ra8876_t *dev, uint32_t addr) {
+    for (uint32_t i = 0; i < RA8876_SPI_CAL_PASSES; i++)
+        if (!link_test(dev, addr, dev->spi_speed ^ (i * 0x9E3779B9))) return false;
+    return true;
 }
 
-void ra8876_draw_rounded_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t r, uint32_t color) {
-    set_two_points(dev, x, y, x + w - 1, y + h - 1);
-    reg_wr16(dev, RA8876_ELL_A, r);
-    reg_wr16(dev, RA8876_ELL_B, r);
-    set_draw_color(dev, color);
-    draw_and_wait(dev, RA8876_DCR1, 0xB0);
+static uint16_t link_rows(ra8876_t *dev) {
+    uint32_t row = (uint32_t)dev->width * ra8876_pixel_bytes(dev);
+    return (RA8876_SPI_CAL_BYTES + row - 1) / row;
 }
 
-void ra8876_fill_triangle(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint32_t color) {
-    set_three_points(dev, x0, y0, x1, y1, x2, y2);
-    set_draw_color(dev, color);
-    draw_and_wait(dev, RA8876_DCR0, 0xE2);
+static bool link_try(ra8876_t *dev, uint32_t addr, uint32_t hz) {
+    dev->spi_speed = spi_set_baudrate(dev->spi, hz);
+    return link_passes(dev, addr);
 }
 
-void ra8876_draw_triangle(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint32_t color) {
+uint32_t ra8876_spi_calibrate(ra8876_t *dev, uint32_t max_hz, bool use_flash) {
+    if (dev->transport != &ra8876_spi_transport) return dev->spi_speed;
+    if (!dev->spi_floor) dev->spi_floor = dev->spi_speed;
+    uint32_t base = dev->spi_floor;
+
     ra8876_wait_task_busy(dev);
-    set_three_points(dev, x0, y0, x1, y1, x2, y2);
-    set_draw_color(dev, color);
-    draw_and_wait(dev, RA8876_DCR0, 0xA2);
-}
+    uint32_t scratch = ra8876_sdram_alloc(dev, link_rows(dev));
+
+    const spi_cal_record_t *rec = use_flash ? spi_cal_find(dev) : NULL;
+    bool found = rec && rec->hz >= base && rec->hz <= max_hz && link_try(dev, scratch, rec->hz);
+
+    if (!found) {
+        uint32_t top = 0, last = 0;
+        for (uint32_t hz = base; hz <= max_hz; hz += RA8876_SPI_CAL_STEP) {
+            uint32_t actual = spi_set_baudrate(dev->spi, hz);
+            if (actual == last) continue;
+            last = actual;
+            if (!link_try(dev, scratch, actual)) break;
+            top = actual;
+        }
+        uint32_t hz = top - top / 100 * RA8876_SPI_CAL_MARGIN;
+        if (hz < base) hz = base;
+        found = (top && link_try(dev, scratch, hz)) || link_try(dev, scratch, base);
+        if (found && use_flash) ra8876_spi_save(dev);
+    }
 
-void ra8876_fill_screen(ra8876_t *dev, uint32_t color) {
-    ra8876_fill_rect(dev, 0, 0, dev->width, dev->height, color);
+    if (scratch != RA8876_SDRAM_NONE) ra8876_sdram_release(dev, scratch);
+    dev->link_errors = 0;
+    return found ? dev->spi_speed : 0;
 }
 
-void ra8876_draw_curve(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint8_t quadrant, uint32_t color) {
-    draw_ellipse(dev, x, y, rx, ry, color, 0x90 | (quadrant & 0x03));
+bool ra8876_spi_verify(ra8876_t *dev) {
+    if (dev->transport != &ra8876_spi_transport) return true;
+    ra8876_wait_task_busy(dev);
+    uint32_t scratch = ra8876_sdram_alloc(dev, link_rows(dev));
+    bool ok = link_passes(dev, scratch);
+    while (!ok && dev->spi_floor && dev->spi_speed > dev->spi_floor) {
+        uint32_t hz = dev->spi_speed - RA8876_SPI_CAL_STEP;
+        ok = link_try(dev, scratch, hz < dev->spi_floor ? dev->spi_floor : hz);
+    }
+    if (scratch != RA8876_SDRAM_NONE) ra8876_sdram_release(dev, scratch);
+    return ok;
 }
 
-void ra8876_fill_curve(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint8_t quadrant, uint32_t color) {
-    draw_ellipse(dev, x, y, rx, ry, color, 0xD0 | (quadrant & 0x03));
+enum {
+    CLIP_LEFT   = 1,
+    CLIP_RIGHT  = 2,
+    CLIP_TOP    = 4,
+    CLIP_BOTTOM = 8,
+};
+
+enum {
+    CLIP_OUT  = 0,
+    CLIP_IN   = 1,
+    CLIP_PART = 2,
+};
+
+static uint8_t clip_code(int32_t x, int32_t y, int32_t xmin, int32_t ymin, int32_t xmax, int32_t ymax) {
+    uint8_t code = 0;
+    if (x < xmin) code |= CLIP_LEFT;
+    else if (x > xmax) code |= CLIP_RIGHT;
+    if (y < ymin) code |= CLIP_TOP;
+    else if (y > ymax) code |= CLIP_BOTTOM;
+    return code;
 }
 
-void ra8876_set_text_mode(ra8876_t *dev) {
-    ra8876_wait_task_busy(dev);
-    dev->reg03 |= 0x04;
-    reg_wr(dev, RA8876_ICR, dev->reg03);
+static bool clip_line(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1,
+                      int32_t xmin, int32_t ymin, int32_t xmax, int32_t ymax) {
+    uint8_t c0 = clip_code(*x0, *y0, xmin, ymin, xmax, ymax);
+    uint8_t c1 = clip_code(*x1, *y1, xmin, ymin, xmax, ymax);
+    while (c0 | c1) {
+        if (c0 & c1) return false;
+        uint8_t c = c0 ? c0 : c1;
+        int64_t dx = *x1 - *x0, dy = *y1 - *y0;
+        int32_t x, y;
+        if (c & CLIP_TOP) {
+            x = *x0 + dx * (ymin - *y0) / dy;
+            y = ymin;
+        } else if (c & CLIP_BOTTOM) {
+            x = *x0 + dx * (ymax - *y0) / dy;
+            y = ymax;
+        } else if (c & CLIP_LEFT) {
+            y = *y0 + dy * (xmin - *x0) / dx;
+            x = xmin;
+        } else {
+            y = *y0 + dy * (xmax - *x0) / dx;
+            x = xmax;
+        }
+        if (c == c0) {
+            *x0 = x;
+            *y0 = y;
+            c0 = clip_code(x, y, xmin, ymin, xmax, ymax);
+        } else {
+            *x1 = x;
+            *y1 = y;
+            c1 = clip_code(x, y, xmin, ymin, xmax, ymax);
+        }
+    }
+    return true;
 }
 
-void ra8876_set_graphics_mode(ra8876_t *dev) {
-    ra8876_wait_task_busy(dev);
-    dev->reg03 &= ~0x04;
-    reg_wr(dev, RA8876_ICR, dev->reg03);
+void ra8876_clip_reset(ra8876_t *dev) {
+    dev->clip.x = 0;
+    dev->clip.y = 0;
+    dev->clip.w = dev->width;
+    dev->clip.h = dev->height;
+    dev->clip_depth = 0;
 }
 
-void ra8876_select_internal_font(ra8876_t *dev, uint8_t size, uint8_t encoding) {
-    switch (size) {
-        case RA8876_FONT_24: dev->char_width = 12; dev->char_height = 24; break;
-        case RA8876_FONT_32: dev->char_width = 16; dev->char_height = 32; break;
-        default: dev->char_width = 8; dev->char_height = 16; break;
-    }
-    dev->regCC = ((size & 0x03) << 4) | (encoding & 0x03);
-    reg_wr(dev, RA8876_CCR0, dev->regCC);
-    reg_wr(dev, RA8876_CCR1, dev->regCD);
+bool ra8876_clip_push(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (dev->clip_depth >= RA8876_CLIP_DEPTH) return false;
+    ra8876_rect_t *c = &dev->clip;
+    dev->clip_stack[dev->clip_depth++] = *c;
+    int32_t x0 = x > c->x ? x : c->x, y0 = y > c->y ? y : c->y;
+    int32_t x1 = x + w < c->x + c->w ? x + w : c->x + c->w;
+    int32_t y1 = y + h < c->y + c->h ? y + h : c->y + c->h;
+    c->x = x0;
+    c->y = y0;
+    c->w = x1 > x0 ? x1 - x0 : 0;
+    c->h = y1 > y0 ? y1 - y0 : 0;
+    return true;
 }
 
-void ra8876_set_fg_color(ra8876_t *dev, uint32_t color) {
-    set_draw_color(dev, color);
+void ra8876_clip_pop(ra8876_t *dev) {
+    if (dev->clip_depth > 0) dev->clip = dev->clip_stack[--dev->clip_depth];
 }
 
-void ra8876_set_bg_color(ra8876_t *dev, uint32_t color) {
-    set_bg_draw_color(dev, color);
+bool ra8876_clip_visible(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h) {
+    const ra8876_rect_t *c = &dev->clip;
+    return w > 0 && h > 0 && x < c->x + c->w && y < c->y + c->h && x + w > c->x && y + h > c->y;
 }
 
-void ra8876_set_text_colors(ra8876_t *dev, uint32_t fg, uint32_t bg) {
-    ra8876_set_fg_color(dev, fg);
-    ra8876_set_bg_color(dev, bg);
+static uint8_t clip_class(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    const ra8876_rect_t *c = &dev->clip;
+    if (x1 < x0 || y1 < y0 || !ra8876_clip_visible(dev, x0, y0, x1 - x0 + 1, y1 - y0 + 1)) {
+        dev->ops_culled++;
+        return CLIP_OUT;
+    }
+    dev->ops_submitted++;
+    if (x0 >= c->x && y0 >= c->y && x1 < c->x + c->w && y1 < c->y + c->h) return CLIP_IN;
+    dev->ops_trimmed++;
+    return CLIP_PART;
 }
 
-void ra8876_set_text_transparent(ra8876_t *dev, bool transparent) {
-    if (transparent)
-        dev->regCD |= 0x40;
-    else
-        dev->regCD &= ~0x40;
-    reg_wr(dev, RA8876_CCR1, dev->regCD);
+static bool clip_box(ra8876_t *dev, uint32_t addr, int32_t *x, int32_t *y, int32_t *w, int32_t *h) {
+    int32_t cx0 = 0, cy0 = 0, cx1 = dev->width, cy1 = RA8876_COORD_MAX + 1;
+    if (addr == dev->canvas_addr) {
+        cx0 = dev->clip.x;
+        cy0 = dev->clip.y;
+        cx1 = cx0 + dev->clip.w;
+        cy1 = cy0 + dev->clip.h;
+    }
+    int32_t x0 = *x > cx0 ? *x : cx0, y0 = *y > cy0 ? *y : cy0;
+    int32_t x1 = *x + *w < cx1 ? *x + *w : cx1, y1 = *y + *h < cy1 ? *y + *h : cy1;
+    if (*w <= 0 || *h <= 0 || x1 <= x0 || y1 <= y0) {
+        dev->ops_culled++;
+        return false;
+    }
+    dev->ops_submitted++;
+    if (x0 != *x || y0 != *y || x1 - x0 != *w || y1 - y0 != *h) dev->ops_trimmed++;
+    *x = x0;
+    *y = y0;
+    *w = x1 - x0;
+    *h = y1 - y0;
+    return true;
 }
 
-void ra8876_set_text_scale(ra8876_t *dev, uint8_t sx, uint8_t sy) {
-    if (sx < 1) sx = 1; if (sx > 4) sx = 4;
-    if (sy < 1) sy = 1; if (sy > 4) sy = 4;
-    dev->regCD = (dev->regCD & 0xF0) | ((sx - 1) << 2) | (sy - 1);
-    reg_wr(dev, RA8876_CCR1, dev->regCD);
+static bool clip_segment(ra8876_t *dev, int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1) {
+    int32_t ox0 = *x0, oy0 = *y0, ox1 = *x1, oy1 = *y1;
+    const ra8876_rect_t *c = &dev->clip;
+    if (c->w <= 0 || c->h <= 0 || !clip_line(x0, y0, x1, y1, c->x, c->y, c->x + c->w - 1, c->y + c->h - 1)) {
+        dev->ops_culled++;
+        return false;
+    }
+    dev->ops_submitted++;
+    if (ox0 != *x0 || oy0 != *y0 || ox1 != *x1 || oy1 != *y1) dev->ops_trimmed++;
+    return true;
 }
 
-void ra8876_set_text_rotation(ra8876_t *dev, bool rotate90) {
-    if (rotate90)
-        dev->regCD |= 0x10;
-    else
-        dev->regCD &= ~0x10;
-    reg_wr(dev, RA8876_CCR1, dev->regCD);
+static void window_begin(ra8876_t *dev, ra8876_rect_t *saved) {
+    saved->x = dev->aw_x;
+    saved->y = dev->aw_y;
+    saved->w = dev->aw_w;
+    saved->h = dev->aw_h;
+    const ra8876_rect_t *c = &dev->clip;
+    int32_t x0 = c->x > dev->aw_x ? c->x : dev->aw_x, y0 = c->y > dev->aw_y ? c->y : dev->aw_y;
+    int32_t x1 = c->x + c->w < dev->aw_x + dev->aw_w ? c->x + c->w : dev->aw_x + dev->aw_w;
+    int32_t y1 = c->y + c->h < dev->aw_y + dev->aw_h ? c->y + c->h : dev->aw_y + dev->aw_h;
+    ra8876_set_active_window(dev, x0, y0, x1 > x0 ? x1 - x0 : 1, y1 > y0 ? y1 - y0 : 1);
 }
 
-void ra8876_set_text_spacing(ra8876_t *dev, uint8_t line_gap, uint8_t char_gap) {
-    reg_wr(dev, RA8876_FLDR, line_gap & 0x1F);
-    reg_wr(dev, RA8876_F2FSSR, char_gap & 0x3F);
+static void window_end(ra8876_t *dev, const ra8876_rect_t *saved) {
+    ra8876_set_active_window(dev, saved->x, saved->y, saved->w, saved->h);
 }
 
-void ra8876_set_text_cursor(ra8876_t *dev, uint16_t x, uint16_t y) {
-    reg_wr16(dev, RA8876_F_CURX, x);
-    reg_wr16(dev, RA8876_F_CURY, y);
+static void clip_suspend(ra8876_t *dev, ra8876_rect_t *saved) {
+    *saved = dev->clip;
+    dev->clip = (ra8876_rect_t){ 0, 0, dev->width, dev->height };
 }
 
-void ra8876_put_string(ra8876_t *dev, const char *s) {
-    size_t len = strlen(s);
-    if (len == 0) return;
-    ra8876_set_text_mode(dev);
-    cmd(dev, RA8876_MRWDP);
-    ra8876_write_data_burst(dev, (const uint8_t *)s, len);
-    ra8876_set_graphics_mode(dev);
+static void clip_resume(ra8876_t *dev, const ra8876_rect_t *saved) {
+    dev->clip = *saved;
 }
 
-void ra8876_print(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *s) {
-    ra8876_set_fg_color(dev, color);
-    ra8876_set_text_cursor(dev, x, y);
-    ra8876_put_string(dev, s);
+static void clip_narrow(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    ra8876_rect_t *c = &dev->clip;
+    int32_t cx0 = x0 > c->x ? x0 : c->x, cy0 = y0 > c->y ? y0 : c->y;
+    int32_t cx1 = x1 + 1 < c->x + c->w ? x1 + 1 : c->x + c->w;
+    int32_t cy1 = y1 + 1 < c->y + c->h ? y1 + 1 : c->y + c->h;
+    *c = (ra8876_rect_t){ cx0, cy0, cx1 > cx0 ? cx1 - cx0 : 0, cy1 > cy0 ? cy1 - cy0 : 0 };
 }
 
-void ra8876_printf(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *fmt, ...) {
-    char buf[256];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
-    ra8876_print(dev, x, y, color, buf);
+static bool hw_point(int32_t x, int32_t y) {
+    return x >= 0 && y >= 0 && x <= RA8876_COORD_MAX && y <= RA8876_COORD_MAX;
 }
 
-void ra8876_set_canvas_addr(ra8876_t *dev, uint32_t addr) {
-    dev->canvas_addr = addr;
-    reg_wr32(dev, RA8876_CVSSA, addr);
-    ra8876_wait_ready(dev);
+static void hw_fill(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    const ra8876_rect_t *c = &dev->clip;
+    if (x0 < c->x) x0 = c->x;
+    if (y0 < c->y) y0 = c->y;
+    if (x1 > c->x + c->w - 1) x1 = c->x + c->w - 1;
+    if (y1 > c->y + c->h - 1) y1 = c->y + c->h - 1;
+    if (x1 < x0 || y1 < y0) return;
+    touch(dev, dev->canvas_addr, x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+    set_two_points(dev, x0, y0, x1, y1);
+    draw_and_wait(dev, RA8876_DCR1, 0xE0);
 }
 
-void ra8876_set_canvas_page(ra8876_t *dev, uint8_t page) {
-    if (page >= dev->max_pages) page = dev->max_pages - 1;
-    ra8876_set_canvas_addr(dev, ra8876_page_addr(dev, page));
+static int32_t box_inset(int32_t y, int32_t y0, int32_t y1, int32_t rx, int32_t ry) {
+    int32_t d = y < y0 + ry ? y0 + ry - y : y > y1 - ry ? y - (y1 - ry) : 0;
+    if (d <= 0 || ry <= 0) return 0;
+    float t = (float)d / ry;
+    return rx - (int32_t)(rx * sqrtf(1.0f - t * t) + 0.5f);
 }
 
-void ra8876_set_canvas(ra8876_t *dev, uint32_t addr, uint16_t width) {
-    dev->canvas_addr = addr;
-    reg_wr32(dev, RA8876_CVSSA, addr);
-    reg_wr16(dev, RA8876_CVS_IMWTH, width);
-    ra8876_wait_ready(dev);
+static void soft_box(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                     int32_t rx, int32_t ry, uint32_t color, bool fill) {
+    const ra8876_rect_t *c = &dev->clip;
+    int32_t ys = y0 > c->y ? y0 : c->y, ye = y1 < c->y + c->h - 1 ? y1 : c->y + c->h - 1;
+    int32_t run[2][3] = { { 0, -1, 0 }, { 0, -1, 0 } };
+    set_draw_color(dev, color);
+    for (int32_t y = ys; y <= ye + 1; y++) {
+        int32_t span[2][2] = { { 0, -1 }, { 0, -1 } };
+        if (y <= ye) {
+            int32_t in = box_inset(y, y0, y1, rx, ry);
+            int32_t l = x0 + in, r = x1 - in;
+            span[0][0] = l;
+            span[0][1] = r;
+            if (!fill && y > y0 && y < y1) {
+                int32_t ia = box_inset(y - 1, y0, y1, rx, ry), ib = box_inset(y + 1, y0, y1, rx, ry);
+                int32_t inner = ia < ib ? ia : ib;
+                int32_t le = x0 + inner - 1, rs = x1 - inner + 1;
+                if (le < l) le = l;
+                if (rs > r) rs = r;
+                if (le + 1 < rs) {
+                    span[0][1] = le;
+                    span[1][0] = rs;
+                    span[1][1] = r;
+                }
+            }
+        }
+        for (uint8_t k = 0; k < 2; k++) {
+            if (run[k][1] >= run[k][0] && run[k][0] == span[k][0] && run[k][1] == span[k][1]) continue;
+            if (run[k][1] >= run[k][0]) hw_fill(dev, run[k][0], run[k][2], run[k][1], y - 1);
+            run[k][0] = span[k][0];
+            run[k][1] = span[k][1];
+            run[k][2] = y;
+        }
+    }
 }
 
-void ra8876_set_display_addr(ra8876_t *dev, uint32_t addr) {
-    reg_wr32(dev, RA8876_MISA, addr);
-    ra8876_wait_ready(dev);
+void ra8876_fill_rect_s(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    if (!clip_box(dev, dev->canvas_addr, &x, &y, &w, &h)) return;
+    touch(dev, dev->canvas_addr, x, y, w, h);
+    stream_begin(dev);
+    set_two_points(dev, x, y, x + w - 1, y + h - 1);
+    set_draw_color(dev, color);
+    draw_and_wait(dev, RA8876_DCR1, 0xE0);
+    stream_end(dev);
 }
 
-void ra8876_set_active_window(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
-    reg_wr16(dev, RA8876_AWUL_X, x);
-    reg_wr16(dev, RA8876_AWUL_Y, y);
-    reg_wr16(dev, RA8876_AW_WTH, w);
-    reg_wr16(dev, RA8876_AW_HT, h);
+void ra8876_fill_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t color) {
+    ra8876_fill_rect_s(dev, x, y, w, h, color);
 }
 
-void ra8876_scroll(ra8876_t *dev, uint16_t x, uint16_t y) {
-    reg_wr16(dev, RA8876_MWULX, x);
-    reg_wr16(dev, RA8876_MWULY, y);
+void ra8876_draw_rect_s(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    uint8_t vis = clip_class(dev, x, y, x + w - 1, y + h - 1);
+    if (vis == CLIP_OUT) return;
+    if (vis == CLIP_PART) {
+        set_draw_color(dev, color);
+        hw_fill(dev, x, y, x + w - 1, y);
+        hw_fill(dev, x, y + h - 1, x + w - 1, y + h - 1);
+        hw_fill(dev, x, y + 1, x, y + h - 2);
+        hw_fill(dev, x + w - 1, y + 1, x + w - 1, y + h - 2);
+        return;
+    }
+    touch(dev, dev->canvas_addr, x, y, w, h);
+    set_two_points(dev, x, y, x + w - 1, y + h - 1);
+    set_draw_color(dev, color);
+    draw_and_wait(dev, RA8876_DCR1, 0xA0);
 }
 
-void ra8876_set_write_direction(ra8876_t *dev, uint8_t dir) {
-    dev->reg02 = (dev->reg02 & ~0x06) | ((dir & 0x03) << 1);
-    reg_wr(dev, RA8876_MACR, dev->reg02);
+void ra8876_draw_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t color) {
+    ra8876_draw_rect_s(dev, x, y, w, h, color);
 }
 
-void ra8876_set_display_flip(ra8876_t *dev, bool flip) {
-    uint8_t val = ra8876_read_reg(dev, RA8876_DPCR);
-    if (flip)
-        val |= 0x08;
-    else
-        val &= ~0x08;
-    reg_wr(dev, RA8876_DPCR, val);
+void ra8876_draw_line_s(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    if (!clip_segment(dev, &x0, &y0, &x1, &y1)) return;
+    touch_span(dev, x0, y0, x1, y1);
+    set_two_points(dev, x0, y0, x1, y1);
+    set_draw_color(dev, color);
+    draw_and_wait(dev, RA8876_DCR0, 0x80);
 }
 
-void ra8876_set_gamma(ra8876_t *dev, bool enable) {
-    if (enable)
-        dev->reg3C |= 0x80;
-    else
-        dev->reg3C &= ~0x80;
-    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+void ra8876_draw_line(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
+    ra8876_draw_line_s(dev, x0, y0, x1, y1, color);
 }
 
-void ra8876_buffer_init(ra8876_t *dev, uint8_t num_pages) {
-    if (num_pages < 1) num_pages = 1;
-    if (num_pages > dev->max_pages) num_pages = dev->max_pages;
-
-    ra8876_wait_task_busy(dev);
-    ra8876_wait_vsync(dev);
-
-    dev->num_pages = num_pages;
-    dev->display_page = 0;
-    dev->draw_page = (num_pages > 1) ? 1 : 0;
-
-    ra8876_set_display_addr(dev, 0);
+static void draw_segment(ra8876_t *dev, ra8876_point_t a, ra8876_point_t b) {
+    int32_t x0 = a.x, y0 = a.y, x1 = b.x, y1 = b.y;
+    if (!clip_segment(dev, &x0, &y0, &x1, &y1)) return;
+    touch_span(dev, x0, y0, x1, y1);
+    set_line_points(dev, x0, y0, x1, y1);
+    draw_and_wait(dev, RA8876_DCR0, 0x80);
+}
 
-    for (uint8_t i = 0; i < num_pages; i++) {
-        ra8876_set_canvas_page(dev, i);
-        ra8876_fill_screen(dev, RA8876_BLACK);
+void ra8876_draw_polyline(ra8876_t *dev, const ra8876_point_t *pts, size_t count, uint32_t color) {
+    if (count < 2) return;
+    set_draw_color(dev, color);
+    for (size_t i = 1; i < count; i++) {
+        if (pts[i].x == pts[i - 1].x && pts[i].y == pts[i - 1].y) continue;
+        draw_segment(dev, pts[i - 1], pts[i]);
     }
+}
 
-    ra8876_set_canvas_page(dev, dev->draw_page);
+void ra8876_draw_polygon(ra8876_t *dev, const ra8876_point_t *pts, size_t count, uint32_t color) {
+    ra8876_draw_polyline(dev, pts, count, color);
+    if (count > 2) draw_segment(dev, pts[count - 1], pts[0]);
 }
 
-void ra8876_vsync_init(ra8876_t *dev) {
-    reg_wr(dev, RA8876_INTEN, ra8876_read_reg(dev, RA8876_INTEN) | 0x10);
-    reg_wr(dev, RA8876_INTF, 0x10);
+void ra8876_draw_line_fan(ra8876_t *dev, const ra8876_point_t *pts, size_t count, uint32_t color) {
+    if (count < 2) return;
+    set_draw_color(dev, color);
+    for (size_t i = 1; i < count; i++)
+        draw_segment(dev, pts[0], pts[i]);
 }
 
-void ra8876_wait_vsync(ra8876_t *dev) {
-    while ((ra8876_read_reg(dev, RA8876_INTF) & 0x10) == 0);
-    reg_wr(dev, RA8876_INTF, 0x10);
+static int32_t cross3(ra8876_point_t a, ra8876_point_t b, ra8876_point_t c) {
+    return ((int32_t)b.x - a.x) * ((int32_t)c.y - a.y) - ((int32_t)b.y - a.y) * ((int32_t)c.x - a.x);
 }
 
-void ra8876_swap_buffers(ra8876_t *dev) {
-    if (dev->num_pages < 2) return;
+static bool same_point(ra8876_point_t a, ra8876_point_t b) {
+    return a.x == b.x && a.y == b.y;
+}
 
-    ra8876_wait_task_busy(dev);
-    ra8876_wait_vsync(dev);
+static bool inside_triangle(ra8876_point_t p, ra8876_point_t a, ra8876_point_t b, ra8876_point_t c, int32_t sign) {
+    if (same_point(p, a) || same_point(p, b) || same_point(p, c)) return false;
+    return cross3(a, b, p) * sign >= 0 && cross3(b, c, p) * sign >= 0 && cross3(c, a, p) * sign >= 0;
+}
 
-    dev->display_page = dev->draw_page;
-    dev->draw_page = (dev->draw_page + 1) % dev->num_pages;
+static bool clip_inside(ra8876_point_t p, uint8_t edge, int32_t bound) {
+    switch (edge) {
+        case CLIP_LEFT: return p.x >= bound;
+        case CLIP_RIGHT: return p.x <= bound;
+        case CLIP_TOP: return p.y >= bound;
+        default: return p.y <= bound;
+    }
+}
 
-    ra8876_set_display_addr(dev, ra8876_page_addr(dev, dev->display_page));
-    ra8876_set_canvas_addr(dev, ra8876_page_addr(dev, dev->draw_page));
+static ra8876_point_t clip_intersect(ra8876_point_t a, ra8876_point_t b, uint8_t edge, int32_t bound) {
+    ra8876_point_t r;
+    if (edge == CLIP_LEFT || edge == CLIP_RIGHT) {
+        r.x = bound;
+        r.y = a.y + (int64_t)(b.y - a.y) * (bound - a.x) / (b.x - a.x);
+    } else {
+        r.y = bound;
+        r.x = a.x + (int64_t)(b.x - a.x) * (bound - a.y) / (b.y - a.y);
+    }
+    return r;
 }
 
-void ra8876_buffer_disable(ra8876_t *dev) {
-    ra8876_wait_task_busy(dev);
-    dev->num_pages = 1;
-    dev->draw_page = 0;
-    dev->display_page = 0;
-    ra8876_set_display_addr(dev, 0);
-    ra8876_set_canvas_addr(dev, 0);
+static bool clip_polygon(const ra8876_point_t *in, size_t n, ra8876_point_t *out, size_t *m, uint8_t edge,
+                         int32_t bound) {
+    *m = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (*m + 2 > RA8876_POLYGON_MAX * 2) return false;
+        ra8876_point_t a = in[(i + n - 1) % n], b = in[i];
+        bool ain = clip_inside(a, edge, bound), bin = clip_inside(b, edge, bound);
+        if (ain != bin) out[(*m)++] = clip_intersect(a, b, edge, bound);
+        if (bin) out[(*m)++] = b;
+    }
+    return true;
 }
 
-uint8_t ra8876_get_draw_page(ra8876_t *dev) { return dev->draw_page; }
+bool ra8876_fill_polygon(ra8876_t *dev, const ra8876_point_t *pts, size_t count, uint32_t color) {
+    ra8876_point_t buf[2][RA8876_POLYGON_MAX * 2];
+    if (count < 3 || count > RA8876_POLYGON_MAX) return false;
+
+    const ra8876_point_t *p = pts;
+    int32_t lx = pts[0].x, ly = pts[0].y, hx = pts[0].x, hy = pts[0].y;
+    for (size_t i = 1; i < count; i++) {
+        if (pts[i].x < lx) lx = pts[i].x;
+        if (pts[i].x > hx) hx = pts[i].x;
+        if (pts[i].y < ly) ly = pts[i].y;
+        if (pts[i].y > hy) hy = pts[i].y;
+    }
+    uint8_t vis = clip_class(dev, lx, ly, hx, hy);
+    if (vis == CLIP_OUT) return true;
+    if (vis == CLIP_PART) {
+        const uint8_t edges[4] = { CLIP_LEFT, CLIP_RIGHT, CLIP_TOP, CLIP_BOTTOM };
+        const int32_t bounds[4] = { dev->clip.x, dev->clip.x + dev->clip.w - 1, dev->clip.y, dev->clip.y + dev->clip.h - 1 };
+        for (uint8_t e = 0; e < 4 && count >= 3; e++) {
+            if (!clip_polygon(p, count, buf[e & 1], &count, edges[e], bounds[e])) return false;
+            p = buf[e & 1];
+        }
+        if (count < 3) return true;
+    }
 
-static void bte_set_source0(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t x, uint16_t y) {
-    reg_wr32(dev, RA8876_S0_STR, addr);
-    reg_wr16(dev, RA8876_S0_WTH, width);
-    reg_wr16(dev, RA8876_S0_X, x);
-    reg_wr16(dev, RA8876_S0_Y, y);
-}
+    uint8_t idx[RA8876_POLYGON_MAX * 2];
+    size_t m = 0;
+    int32_t area = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (m > 0 && same_point(p[idx[m - 1]], p[i])) continue;
+        idx[m++] = i;
+    }
+    while (m > 1 && same_point(p[idx[m - 1]], p[idx[0]])) m--;
+    if (m < 3) return true;
+    for (size_t i = 0; i < m; i++) {
+        ra8876_point_t a = p[idx[i]], b = p[idx[(i + 1) % m]];
+        area += (int32_t)a.x * b.y - (int32_t)b.x * a.y;
+    }
+    if (area == 0) return true;
+    int32_t sign = area > 0 ? 1 : -1;
+
+    uint8_t tri[RA8876_POLYGON_MAX * 2][3];
+    size_t n = 0, i = 0;
+    while (m >= 3) {
+        size_t tries = 0;
+        for (; tries < m; tries++, i = (i + 1) % m) {
+            ra8876_point_t a = p[idx[(i + m - 1) % m]], b = p[idx[i]], c = p[idx[(i + 1) % m]];
+            int32_t turn = cross3(a, b, c) * sign;
+            if (turn == 0) break;
+            if (turn < 0) continue;
+            bool ear = true;
+            for (size_t j = 0; j < m && ear; j++) {
+                if (j != i && j != (i + m - 1) % m && j != (i + 1) % m && inside_triangle(p[idx[j]], a, b, c, sign))
+                    ear = false;
+            }
+            if (ear) break;
+        }
+        if (tries == m) return false;
+        if (cross3(p[idx[(i + m - 1) % m]], p[idx[i]], p[idx[(i + 1) % m]]) != 0) {
+            tri[n][0] = idx[(i + m - 1) % m];
+            tri[n][1] = idx[i];
+            tri[n++][2] = idx[(i + 1) % m];
+        }
+        if (m == 3) break;
+        for (size_t j = i; j + 1 < m; j++)
+            idx[j] = idx[j + 1];
+        m--;
+        i = (i + m - 1) % m;
+    }
 
-static void bte_set_source1(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t x, uint16_t y) {
-    reg_wr32(dev, RA8876_S1_STR, addr);
-    reg_wr16(dev, RA8876_S1_WTH, width);
-    reg_wr16(dev, RA8876_S1_X, x);
-    reg_wr16(dev, RA8876_S1_Y, y);
+    set_draw_color(dev, color);
+    for (size_t t = 0; t < n; t++) {
+        ra8876_point_t a = p[tri[t][0]], b = p[tri[t][1]], c = p[tri[t][2]];
+        touch_span(dev, a.x < b.x ? (a.x < c.x ? a.x : c.x) : (b.x < c.x ? b.x : c.x),
+                   a.y < b.y ? (a.y < c.y ? a.y : c.y) : (b.y < c.y ? b.y : c.y),
+                   a.x > b.x ? (a.x > c.x ? a.x : c.x) : (b.x > c.x ? b.x : c.x),
+                   a.y > b.y ? (a.y > c.y ? a.y : c.y) : (b.y > c.y ? b.y : c.y));
+        set_triangle_points(dev, a.x, a.y, b.x, b.y, c.x, c.y);
+        draw_and_wait(dev, RA8876_DCR0, 0xE2);
+    }
+    return true;
 }
 
-static void bte_set_dest(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t x, uint16_t y) {
-    reg_wr32(dev, RA8876_DT_STR, addr);
-    reg_wr16(dev, RA8876_DT_WTH, width);
-    reg_wr16(dev, RA8876_DT_X, x);
-    reg_wr16(dev, RA8876_DT_Y, y);
+static void draw_ellipse(ra8876_t *dev, int32_t x, int32_t y, int32_t rx, int32_t ry, uint32_t color, uint8_t cmd) {
+    int32_t x0 = x - rx, y0 = y - ry, x1 = x + rx, y1 = y + ry;
+    if (cmd & 0x10) {
+        uint8_t q = cmd & 0x03;
+        if (q == RA8876_CURVE_UR || q == RA8876_CURVE_BR) x0 = x;
+        else x1 = x;
+        if (q == RA8876_CURVE_UL || q == RA8876_CURVE_UR) y1 = y;
+        else y0 = y;
+    }
+    uint8_t vis = rx < 0 || ry < 0 ? clip_class(dev, 0, 0, -1, -1) : clip_class(dev, x0, y0, x1, y1);
+    if (vis == CLIP_OUT) return;
+    ra8876_rect_t saved;
+    if (vis == CLIP_PART && !hw_point(x, y)) {
+        saved = dev->clip;
+        clip_narrow(dev, x0, y0, x1, y1);
+        soft_box(dev, x - rx, y - ry, x + rx, y + ry, rx, ry, color, cmd & 0x40);
+        clip_resume(dev, &saved);
+        return;
+    }
+    if (vis == CLIP_PART) window_begin(dev, &saved);
+    touch_span(dev, x0, y0, x1, y1);
+    reg_wr16(dev, RA8876_DEHR, x);
+    reg_wr16(dev, RA8876_DEVR, y);
+    reg_wr16(dev, RA8876_ELL_A, rx);
+    reg_wr16(dev, RA8876_ELL_B, ry);
+    set_draw_color(dev, color);
+    draw_and_wait(dev, RA8876_DCR1, cmd);
+    if (vis == CLIP_PART) window_end(dev, &saved);
 }
 
-static void bte_set_size(ra8876_t *dev, uint16_t width, uint16_t height) {
-    reg_wr16(dev, RA8876_BTE_WTH, width);
-    reg_wr16(dev, RA8876_BTE_HIG, height);
+void ra8876_fill_circle_s(ra8876_t *dev, int32_t x, int32_t y, int32_t r, uint32_t color) {
+    draw_ellipse(dev, x, y, r, r, color, 0xC0);
 }
 
-static void bte_start(ra8876_t *dev, uint8_t rop, uint8_t op) {
-    reg_wr(dev, RA8876_BTE_COLR, 0x00);
-    reg_wr(dev, RA8876_BTE_CTRL1, (rop & 0xF0) | (op & 0x0F));
-    reg_wr(dev, RA8876_BTE_CTRL0, 0x10);
-    while (ra8876_read_reg(dev, RA8876_BTE_CTRL0) & 0x10);
+void ra8876_draw_circle_s(ra8876_t *dev, int32_t x, int32_t y, int32_t r, uint32_t color) {
+    draw_ellipse(dev, x, y, r, r, color, 0x80);
 }
 
-static void bte_start_pattern(ra8876_t *dev, uint8_t rop, uint8_t op, bool p16) {
-    reg_wr(dev, RA8876_BTE_COLR, 0x00);
-    reg_wr(dev, RA8876_BTE_CTRL1, (rop & 0xF0) | (op & 0x0F));
-    reg_wr(dev, RA8876_BTE_CTRL0, p16 ? 0x11 : 0x10);
-    while (ra8876_read_reg(dev, RA8876_BTE_CTRL0) & 0x10);
+void ra8876_fill_ellipse_s(ra8876_t *dev, int32_t x, int32_t y, int32_t rx, int32_t ry, uint32_t color) {
+    draw_ellipse(dev, x, y, rx, ry, color, 0xC0);
 }
 
-static void bte_start_mpu(ra8876_t *dev, uint8_t rop, uint8_t op) {
-    reg_wr(dev, RA8876_BTE_COLR, 0x00);
-    reg_wr(dev, RA8876_BTE_CTRL1, (rop & 0xF0) | (op & 0x0F));
-    reg_wr(dev, RA8876_BTE_CTRL0, 0x10);
-    cmd(dev, RA8876_MRWDP);
+void ra8876_draw_ellipse_s(ra8876_t *dev, int32_t x, int32_t y, int32_t rx, int32_t ry, uint32_t color) {
+    draw_ellipse(dev, x, y, rx, ry, color, 0x80);
 }
 
-static void bte_wait_mpu(ra8876_t *dev) {
-    while (ra8876_read_reg(dev, RA8876_BTE_CTRL0) & 0x10);
+void ra8876_fill_circle(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t r, uint32_t color) {
+    draw_ellipse(dev, x, y, r, r, color, 0xC0);
 }
 
-void ra8876_bte_copy(ra8876_t *dev, uint32_t src_addr, uint16_t src_x, uint16_t src_y,
-                     uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
-                     uint16_t width, uint16_t height, uint8_t rop) {
-    ra8876_wait_task_busy(dev);
-    bte_set_source0(dev, src_addr, dev->width, src_x, src_y);
-    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
-    bte_set_size(dev, width, height);
-    bte_start(dev, rop, 0x02);
+void ra8876_draw_circle(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t r, uint32_t color) {
+    draw_ellipse(dev, x, y, r, r, color, 0x80);
 }
 
-void ra8876_bte_copy_chroma(ra8876_t *dev, uint32_t src_addr, uint16_t src_x, uint16_t src_y,
-                            uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
-                            uint16_t width, uint16_t height, uint32_t chroma) {
-    ra8876_wait_task_busy(dev);
-    set_bg_draw_color(dev, chroma);
-    bte_set_source0(dev, src_addr, dev->width, src_x, src_y);
-    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
-    bte_set_size(dev, width, height);
-    bte_start(dev, RA8876_ROP_S, 0x05);
+void ra8876_fill_ellipse(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint32_t color) {
+    draw_ellipse(dev, x, y, rx, ry, color, 0xC0);
 }
 
-void ra8876_bte_blend(ra8876_t *dev, uint32_t s0_addr, uint16_t s0_x, uint16_t s0_y,
-                      uint32_t s1_addr, uint16_t s1_x, uint16_t s1_y,
-                      uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
-                      uint16_t width, uint16_t height, uint8_t alpha) {
-    ra8876_wait_task_busy(dev);
-    bte_set_source0(dev, s0_addr, dev->width, s0_x, s0_y);
-    bte_set_source1(dev, s1_addr, dev->width, s1_x, s1_y);
-    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
-    bte_set_size(dev, width, height);
-    reg_wr(dev, RA8876_APB_CTRL, alpha >> 3);
-    bte_start(dev, RA8876_ROP_S, 0x0A);
+void ra8876_draw_ellipse(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint32_t color) {
+    draw_ellipse(dev, x, y, rx, ry, color, 0x80);
 }
 
-void ra8876_bte_solid_fill(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
-                           uint16_t width, uint16_t height, uint32_t color) {
-    ra8876_wait_task_busy(dev);
+static void rounded_rect(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color, uint8_t cmd) {
+    uint8_t vis = clip_class(dev, x, y, x + w - 1, y + h - 1);
+    if (vis == CLIP_OUT) return;
+    if (r > w / 2) r = w / 2;
+    if (r > h / 2) r = h / 2;
+    if (r < 0) r = 0;
+    if (vis == CLIP_PART && !hw_point(x, y)) {
+        soft_box(dev, x, y, x + w - 1, y + h - 1, r, r, color, cmd == 0xF0);
+        return;
+    }
+    ra8876_rect_t saved;
+    if (vis == CLIP_PART) window_begin(dev, &saved);
+    touch(dev, dev->canvas_addr, x, y, w, h);
+    set_two_points(dev, x, y, x + w - 1, y + h - 1);
+    reg_wr16(dev, RA8876_ELL_A, r);
+    reg_wr16(dev, RA8876_ELL_B, r);
     set_draw_color(dev, color);
-    bte_set_dest(dev, addr, dev->width, x, y);
-    bte_set_size(dev, width, height);
-    bte_start(dev, RA8876_ROP_S, 0x0C);
+    draw_and_wait(dev, RA8876_DCR1, cmd);
+    if (vis == CLIP_PART) window_end(dev, &saved);
 }
 
-void ra8876_bte_batch_start(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t height) {
-    reg_wr32(dev, RA8876_DT_STR, addr);
-    reg_wr16(dev, RA8876_DT_WTH, dev->width);
+void ra8876_fill_rounded_rect_s(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    rounded_rect(dev, x, y, w, h, r, color, 0xF0);
+}
+
+void ra8876_draw_rounded_rect_s(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    rounded_rect(dev, x, y, w, h, r, color, 0xB0);
+}
+
+void ra8876_fill_rounded_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t r, uint32_t color) {
+    rounded_rect(dev, x, y, w, h, r, color, 0xF0);
+}
+
+void ra8876_draw_rounded_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t r, uint32_t color) {
+    rounded_rect(dev, x, y, w, h, r, color, 0xB0);
+}
+
+static void triangle(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+                     uint32_t color, bool fill) {
+    int32_t lx = x0 < x1 ? x0 : x1, ly = y0 < y1 ? y0 : y1;
+    int32_t hx = x0 > x1 ? x0 : x1, hy = y0 > y1 ? y0 : y1;
+    if (x2 < lx) lx = x2;
+    if (y2 < ly) ly = y2;
+    if (x2 > hx) hx = x2;
+    if (y2 > hy) hy = y2;
+    if (!hw_point(lx, ly) || !hw_point(hx, hy)) {
+        if (fill) {
+            ra8876_point_t pts[3] = { { x0, y0 }, { x1, y1 }, { x2, y2 } };
+            ra8876_fill_polygon(dev, pts, 3, color);
+        } else {
+            ra8876_draw_line_s(dev, x0, y0, x1, y1, color);
+            ra8876_draw_line_s(dev, x1, y1, x2, y2, color);
+            ra8876_draw_line_s(dev, x2, y2, x0, y0, color);
+        }
+        return;
+    }
+    uint8_t vis = clip_class(dev, lx, ly, hx, hy);
+    if (vis == CLIP_OUT) return;
+    ra8876_rect_t saved;
+    if (vis == CLIP_PART) window_begin(dev, &saved);
+    touch_span(dev, lx, ly, hx, hy);
+    if (!fill) ra8876_wait_task_busy(dev);
+    stream_begin(dev);
+    set_triangle_points(dev, x0, y0, x1, y1, x2, y2);
+    set_draw_color(dev, color);
+    draw_and_wait(dev, RA8876_DCR0, fill ? 0xE2 : 0xA2);
+    stream_end(dev);
+    if (vis == CLIP_PART) window_end(dev, &saved);
+}
+
+void ra8876_fill_triangle_s(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+    triangle(dev, x0, y0, x1, y1, x2, y2, color, true);
+}
+
+void ra8876_draw_triangle_s(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+    triangle(dev, x0, y0, x1, y1, x2, y2, color, false);
+}
+
+void ra8876_fill_triangle(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint32_t color) {
+    triangle(dev, x0, y0, x1, y1, x2, y2, color, true);
+}
+
+void ra8876_draw_triangle(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint32_t color) {
+    triangle(dev, x0, y0, x1, y1, x2, y2, color, false);
+}
+
+void ra8876_fill_screen(ra8876_t *dev, uint32_t color) {
+    ra8876_fill_rect(dev, 0, 0, dev->width, dev->height, color);
+}
+
+void ra8876_draw_curve(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint8_t quadrant, uint32_t color) {
+    draw_ellipse(dev, x, y, rx, ry, color, 0x90 | (quadrant & 0x03));
+}
+
+void ra8876_fill_curve(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint8_t quadrant, uint32_t color) {
+    draw_ellipse(dev, x, y, rx, ry, color, 0xD0 | (quadrant & 0x03));
+}
+
+void ra8876_set_text_mode(ra8876_t *dev) {
+    ra8876_wait_task_busy(dev);
+    dev->reg03 |= 0x04;
+    reg_wr(dev, RA8876_ICR, dev->reg03);
+}
+
+void ra8876_set_graphics_mode(ra8876_t *dev) {
+    ra8876_wait_task_busy(dev);
+    dev->reg03 &= ~0x04;
+    reg_wr(dev, RA8876_ICR, dev->reg03);
+}
+
+void ra8876_select_internal_font(ra8876_t *dev, uint8_t size, uint8_t encoding) {
+    switch (size) {
+        case RA8876_FONT_24: dev->char_width = 12; dev->char_height = 24; break;
+        case RA8876_FONT_32: dev->char_width = 16; dev->char_height = 32; break;
+        default: dev->char_width = 8; dev->char_height = 16; break;
+    }
+    dev->regCC = ((size & 0x03) << 4) | (encoding & 0x03);
+    reg_wr(dev, RA8876_CCR0, dev->regCC);
+    reg_wr(dev, RA8876_CCR1, dev->regCD);
+}
+
+void ra8876_set_fg_color(ra8876_t *dev, uint32_t color) {
+    set_draw_color(dev, color);
+}
+
+void ra8876_set_bg_color(ra8876_t *dev, uint32_t color) {
+    set_bg_draw_color(dev, color);
+}
+
+void ra8876_set_text_colors(ra8876_t *dev, uint32_t fg, uint32_t bg) {
+    ra8876_set_fg_color(dev, fg);
+    ra8876_set_bg_color(dev, bg);
+}
+
+void ra8876_set_text_transparent(ra8876_t *dev, bool transparent) {
+    if (transparent)
+        dev->regCD |= 0x40;
+    else
+        dev->regCD &= ~0x40;
+    reg_wr(dev, RA8876_CCR1, dev->regCD);
+}
+
+void ra8876_set_text_scale(ra8876_t *dev, uint8_t sx, uint8_t sy) {
+    if (sx < 1) sx = 1; if (sx > 4) sx = 4;
+    if (sy < 1) sy = 1; if (sy > 4) sy = 4;
+    dev->regCD = (dev->regCD & 0xF0) | ((sx - 1) << 2) | (sy - 1);
+    reg_wr(dev, RA8876_CCR1, dev->regCD);
+}
+
+void ra8876_set_text_rotation(ra8876_t *dev, bool rotate90) {
+    if (rotate90)
+        dev->regCD |= 0x10;
+    else
+        dev->regCD &= ~0x10;
+    reg_wr(dev, RA8876_CCR1, dev->regCD);
+}
+
+void ra8876_set_text_spacing(ra8876_t *dev, uint8_t line_gap, uint8_t char_gap) {
+    dev->regD0 = line_gap & 0x1F;
+    dev->regD1 = char_gap & 0x3F;
+    reg_wr(dev, RA8876_FLDR, dev->regD0);
+    reg_wr(dev, RA8876_F2FSSR, dev->regD1);
+}
+
+void ra8876_set_text_cursor(ra8876_t *dev, uint16_t x, uint16_t y) {
+    reg_wr16(dev, RA8876_F_CURX, x);
+    reg_wr16(dev, RA8876_F_CURY, y);
+    dev->text_x = x;
+    dev->text_y = y;
+    dev->text_stale = false;
+}
+
+static void text_sync(ra8876_t *dev) {
+    if (!dev->text_stale) return;
+    reg_wr16(dev, RA8876_F_CURX, dev->text_x);
+    reg_wr16(dev, RA8876_F_CURY, dev->text_y);
+    dev->text_stale = false;
+}
+
+static void text_advance(ra8876_t *dev, size_t len) {
+    uint32_t x = dev->text_x + (uint32_t)len * ra8876_char_advance(dev);
+    if (dev->text_x == RA8876_UNKNOWN_POS || (dev->regCD & 0x10) ||
+        x >= (uint32_t)dev->aw_x + dev->aw_w) {
+        dev->text_x = RA8876_UNKNOWN_POS;
+        dev->text_y = RA8876_UNKNOWN_POS;
+    } else {
+        dev->text_x = x;
+    }
+}
+
+static void touch_text(ra8876_t *dev, size_t len) {
+    if (!dev->backing) return;
+    if (dev->text_x == RA8876_UNKNOWN_POS || dev->text_y == RA8876_UNKNOWN_POS)
+        touch(dev, dev->canvas_addr, 0, 0, dev->width, dev->height);
+    else
+        touch(dev, dev->canvas_addr, dev->text_x, dev->text_y, len * ra8876_char_advance(dev), ra8876_line_pitch(dev));
+}
+
+static uint8_t text_class(ra8876_t *dev, uint16_t x, uint16_t y, size_t len) {
+    if (x == RA8876_UNKNOWN_POS || y == RA8876_UNKNOWN_POS || (dev->regCD & 0x10)) {
+        dev->ops_submitted++;
+        return CLIP_IN;
+    }
+    uint32_t w = (uint32_t)len * ra8876_char_advance(dev);
+    if (x + w >= (uint32_t)dev->aw_x + dev->aw_w) {
+        dev->ops_submitted++;
+        return CLIP_IN;
+    }
+    return clip_class(dev, x, y, x + w - 1, y + ra8876_line_pitch(dev) - 1);
+}
+
+static bool text_trim(ra8876_t *dev, uint16_t *x, const char **s, size_t *len) {
+    const ra8876_rect_t *c = &dev->clip;
+    int32_t adv = ra8876_char_advance(dev);
+    int32_t first = *x < c->x ? (c->x - *x + adv - 1) / adv : 0;
+    int32_t last = ((int32_t)c->x + c->w - *x) / adv;
+    if (last > (int32_t)*len) last = *len;
+    if (first >= last) return false;
+    *x += first * adv;
+    *s += first;
+    *len = last - first;
+    return true;
+}
+
+static void text_skip(ra8876_t *dev, uint16_t x, uint16_t y, size_t len) {
+    dev->text_x = x;
+    dev->text_y = y;
+    text_advance(dev, len);
+    dev->text_stale = true;
+}
+
+static void put_text(ra8876_t *dev, const char *s, size_t len) {
+    text_sync(dev);
+    touch_text(dev, len);
+    ra8876_set_text_mode(dev);
+    cmd(dev, RA8876_MRWDP);
+    ra8876_write_data_burst(dev, (const uint8_t *)s, len);
+    ra8876_set_graphics_mode(dev);
+    text_advance(dev, len);
+}
+
+static void put_text_clipped(ra8876_t *dev, uint16_t x, uint16_t y, const char *s, size_t len) {
+    uint16_t cx = x;
+    const char *t = s;
+    size_t n = len;
+    if (text_trim(dev, &cx, &t, &n)) {
+        ra8876_rect_t saved;
+        window_begin(dev, &saved);
+        dev->text_x = cx;
+        dev->text_y = y;
+        dev->text_stale = true;
+        put_text(dev, t, n);
+        window_end(dev, &saved);
+    }
+    text_skip(dev, x, y, len);
+}
+
+void ra8876_put_string(ra8876_t *dev, const char *s) {
+    size_t len = strlen(s);
+    if (len == 0) return;
+    uint8_t vis = text_class(dev, dev->text_x, dev->text_y, len);
+    if (vis == CLIP_OUT)
+        text_skip(dev, dev->text_x, dev->text_y, len);
+    else if (vis == CLIP_PART)
+        put_text_clipped(dev, dev->text_x, dev->text_y, s, len);
+    else
+        put_text(dev, s, len);
+}
+
+void ra8876_print(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *s) {
+    size_t len = strlen(s);
+    uint8_t vis = len > 0 ? text_class(dev, x, y, len) : CLIP_IN;
+    if (vis == CLIP_OUT) {
+        text_skip(dev, x, y, len);
+        return;
+    }
+    ra8876_set_fg_color(dev, color);
+    if (vis == CLIP_PART) {
+        put_text_clipped(dev, x, y, s, len);
+        return;
+    }
+    ra8876_set_text_cursor(dev, x, y);
+    if (len > 0) put_text(dev, s, len);
+}
+
+void ra8876_printf(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    ra8876_print(dev, x, y, color, buf);
+}
+
+void ra8876_text_begin(ra8876_t *dev) {
+    ra8876_set_text_mode(dev);
+    dev->text_batch = 1;
+}
+
+static void text_batch_sync(ra8876_t *dev) {
+    ra8876_wait_write_fifo_empty(dev);
+    ra8876_wait_task_busy(dev);
+    dev->text_batch = 1;
+}
+
+static void text_batch_emit(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *s, size_t len) {
+    if (color != dev->fg_color || x != dev->text_x || y != dev->text_y || dev->text_stale) {
+        text_batch_sync(dev);
+        set_draw_color(dev, color);
+        if (x != dev->text_x || dev->text_stale) reg_wr16(dev, RA8876_F_CURX, x);
+        if (y != dev->text_y || dev->text_stale) reg_wr16(dev, RA8876_F_CURY, y);
+        dev->text_x = x;
+        dev->text_y = y;
+        dev->text_stale = false;
+    }
+    if (dev->text_batch != 2) {
+        cmd(dev, RA8876_MRWDP);
+        dev->text_batch = 2;
+    }
+    touch_text(dev, len);
+    ra8876_write_data_burst(dev, (const uint8_t *)s, len);
+    text_advance(dev, len);
+}
+
+static void text_batch_write(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *s, size_t len) {
+    uint8_t vis = text_class(dev, x, y, len);
+    if (vis == CLIP_OUT) return;
+    if (vis == CLIP_IN) {
+        text_batch_emit(dev, x, y, color, s, len);
+        return;
+    }
+    if (!text_trim(dev, &x, &s, &len)) return;
+    ra8876_rect_t saved;
+    text_batch_sync(dev);
+    window_begin(dev, &saved);
+    text_batch_emit(dev, x, y, color, s, len);
+    text_batch_sync(dev);
+    window_end(dev, &saved);
+}
+
+void ra8876_text_run(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *s) {
+    while (*s) {
+        size_t len = strcspn(s, "\n");
+        if (len > 0) text_batch_write(dev, x, y, color, s, len);
+        s += len;
+        if (*s == '\n') {
+            s++;
+            y += ra8876_line_pitch(dev);
+        }
+    }
+}
+
+void ra8876_text_end(ra8876_t *dev) {
+    ra8876_wait_write_fifo_empty(dev);
+    ra8876_set_graphics_mode(dev);
+    dev->text_batch = 0;
+}
+
+void ra8876_print_runs(ra8876_t *dev, const ra8876_text_run_t *runs, size_t count) {
+    ra8876_text_begin(dev);
+    for (size_t i = 0; i < count; i++)
+        ra8876_text_run(dev, runs[i].x, runs[i].y, runs[i].color, runs[i].s);
+    ra8876_text_end(dev);
+}
+
+void ra8876_field_init(ra8876_field_t *f, uint16_t x, uint16_t y, uint8_t width, uint32_t fg, uint32_t bg) {
+    if (width > RA8876_FIELD_MAX) width = RA8876_FIELD_MAX;
+    f->x = x;
+    f->y = y;
+    f->width = width;
+    f->fg = fg;
+    f->bg = bg;
+    f->valid = false;
+    memset(f->text, ' ', width);
+    f->text[width] = '\0';
+}
+
+void ra8876_field_invalidate(ra8876_field_t *f) {
+    f->valid = false;
+}
+
+void ra8876_field_set_colors(ra8876_field_t *f, uint32_t fg, uint32_t bg) {
+    if (fg == f->fg && bg == f->bg) return;
+    f->fg = fg;
+    f->bg = bg;
+    f->valid = false;
+}
+
+void ra8876_field_set(ra8876_t *dev, ra8876_field_t *f, const char *s) {
+    char next[RA8876_FIELD_MAX + 1];
+    uint8_t n = 0;
+    while (n < f->width && s[n]) {
+        next[n] = s[n];
+        n++;
+    }
+    memset(&next[n], ' ', f->width - n);
+    next[f->width] = '\0';
+
+    uint8_t i = 0;
+    if (f->valid) {
+        while (i < f->width && next[i] == f->text[i]) i++;
+        if (i == f->width) return;
+    }
+
+    bool own_session = dev->text_batch == 0;
+    if (own_session)
+        ra8876_text_begin(dev);
+
+    uint8_t cd = dev->regCD;
+    if ((cd & 0x40) || f->bg != dev->bg_color) {
+        text_batch_sync(dev);
+        set_bg_draw_color(dev, f->bg);
+        if (cd & 0x40) {
+            dev->regCD = cd & ~0x40;
+            reg_wr(dev, RA8876_CCR1, dev->regCD);
+        }
+    }
+
+    uint16_t adv = ra8876_char_advance(dev);
+    while (i < f->width) {
+        uint8_t start = i;
+        uint8_t end = i + 1;
+        uint8_t same = 0;
+        for (uint8_t j = end; j < f->width; j++) {
+            if (!f->valid || next[j] != f->text[j]) {
+                end = j + 1;
+                same = 0;
+            } else if (++same > RA8876_FIELD_MERGE_GAP) {
+                break;
+            }
+        }
+        text_batch_write(dev, f->x + start * adv, f->y, f->fg, &next[start], end - start);
+        i = end;
+        while (i < f->width && f->valid && next[i] == f->text[i]) i++;
+    }
+
+    if (cd & 0x40) {
+        text_batch_sync(dev);
+        dev->regCD = cd;
+        reg_wr(dev, RA8876_CCR1, dev->regCD);
+    }
+
+    if (own_session)
+        ra8876_text_end(dev);
+
+    memcpy(f->text, next, f->width + 1);
+    f->valid = true;
+}
+
+void ra8876_field_printf(ra8876_t *dev, ra8876_field_t *f, const char *fmt, ...) {
+    char buf[RA8876_FIELD_MAX + 1];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    ra8876_field_set(dev, f, buf);
+}
+
+void ra8876_set_canvas_addr(ra8876_t *dev, uint32_t addr) {
+    dev->canvas_addr = addr;
+    reg_wr32(dev, RA8876_CVSSA, addr);
+    ra8876_wait_ready(dev);
+}
+
+void ra8876_set_canvas_page(ra8876_t *dev, uint8_t page) {
+    if (page >= dev->max_pages) page = dev->max_pages - 1;
+    ra8876_set_canvas_addr(dev, ra8876_page_addr(dev, page));
+}
+
+void ra8876_set_canvas(ra8876_t *dev, uint32_t addr, uint16_t width) {
+    dev->canvas_addr = addr;
+    reg_wr32(dev, RA8876_CVSSA, addr);
+    reg_wr16(dev, RA8876_CVS_IMWTH, width);
+    ra8876_wait_ready(dev);
+}
+
+void ra8876_set_display_addr(ra8876_t *dev, uint32_t addr) {
+    reg_wr32(dev, RA8876_MISA, addr);
+    ra8876_wait_ready(dev);
+}
+
+void ra8876_set_active_window(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    reg_wr16(dev, RA8876_AWUL_X, x);
+    reg_wr16(dev, RA8876_AWUL_Y, y);
+    reg_wr16(dev, RA8876_AW_WTH, w);
+    reg_wr16(dev, RA8876_AW_HT, h);
+    dev->aw_x = x;
+    dev->aw_y = y;
+    dev->aw_w = w;
+    dev->aw_h = h;
+}
+
+void ra8876_scroll(ra8876_t *dev, uint16_t x, uint16_t y) {
+    reg_wr16(dev, RA8876_MWULX, x);
+    reg_wr16(dev, RA8876_MWULY, y);
+}
+
+void ra8876_set_write_direction(ra8876_t *dev, uint8_t dir) {
+    dev->reg02 = (dev->reg02 & ~0x06) | ((dir & 0x03) << 1);
+    reg_wr(dev, RA8876_MACR, dev->reg02);
+}
+
+void ra8876_set_display_flip(ra8876_t *dev, bool flip) {
+    uint8_t val = ra8876_read_reg(dev, RA8876_DPCR);
+    if (flip)
+        val |= 0x08;
+    else
+        val &= ~0x08;
+    reg_wr(dev, RA8876_DPCR, val);
+}
+
+void ra8876_set_gamma(ra8876_t *dev, bool enable) {
+    if (enable)
+        dev->reg3C |= 0x80;
+    else
+        dev->reg3C &= ~0x80;
+    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+}
+
+void ra8876_buffer_init(ra8876_t *dev, uint8_t num_pages) {
+    if (num_pages < 1) num_pages = 1;
+    if (num_pages > dev->max_pages) num_pages = dev->max_pages;
+
+    ra8876_wait_task_busy(dev);
+    ra8876_wait_vsync(dev);
+
+    dev->num_pages = num_pages;
+    dev->display_page = 0;
+    dev->draw_page = (num_pages > 1) ? 1 : 0;
+
+    ra8876_set_display_addr(dev, 0);
+
+    for (uint8_t i = 0; i < num_pages; i++) {
+        ra8876_set_canvas_page(dev, i);
+        ra8876_fill_screen(dev, RA8876_BLACK);
+    }
+
+    ra8876_set_canvas_page(dev, dev->draw_page);
+}
+
+void ra8876_vsync_init(ra8876_t *dev) {
+    reg_wr(dev, RA8876_INTEN, ra8876_read_reg(dev, RA8876_INTEN) | 0x10);
+    reg_wr(dev, RA8876_INTF, 0x10);
+}
+
+void ra8876_wait_vsync(ra8876_t *dev) {
+    while ((ra8876_read_reg(dev, RA8876_INTF) & 0x10) == 0);
+    reg_wr(dev, RA8876_INTF, 0x10);
+}
+
+static void flip_pages(ra8876_t *dev) {
+    dev->display_page = dev->draw_page;
+    dev->draw_page = (dev->draw_page + 1) % dev->num_pages;
+
+    ra8876_set_display_addr(dev, ra8876_page_addr(dev, dev->display_page));
+    ra8876_set_canvas_addr(dev, ra8876_page_addr(dev, dev->draw_page));
+}
+
+void ra8876_swap_buffers(ra8876_t *dev) {
+    if (dev->num_pages < 2) return;
+
+    ra8876_wait_task_busy(dev);
+    ra8876_wait_vsync(dev);
+    flip_pages(dev);
+}
+
+uint32_t ra8876_swap_buffers_group(ra8876_t *const *devs, uint8_t count) {
+    uint32_t pending = 0;
+    for (uint8_t i = 0; i < count && i < 32; i++) {
+        if (devs[i]->num_pages < 2) continue;
+        ra8876_wait_task_busy(devs[i]);
+        pending |= 1u << i;
+    }
+    for (uint8_t i = 0; i < count && i < 32; i++)
+        if (pending & (1u << i)) reg_wr(devs[i], RA8876_INTF, 0x10);
+
+    uint32_t first = 0, last = 0;
+    bool flipped = false;
+    while (pending) {
+        for (uint8_t i = 0; i < count && i < 32; i++) {
+            if (!(pending & (1u << i))) continue;
+            if ((ra8876_read_reg(devs[i], RA8876_INTF) & 0x10) == 0) continue;
+            flip_pages(devs[i]);
+            reg_wr(devs[i], RA8876_INTF, 0x10);
+            pending &= ~(1u << i);
+            last = time_us_32();
+            if (!flipped) first = last;
+            flipped = true;
+        }
+    }
+    return last - first;
+}
+
+void ra8876_buffer_disable(ra8876_t *dev) {
+    ra8876_wait_task_busy(dev);
+    dev->num_pages = 1;
+    dev->draw_page = 0;
+    dev->display_page = 0;
+    ra8876_set_display_addr(dev, 0);
+    ra8876_set_canvas_addr(dev, 0);
+}
+
+uint8_t ra8876_get_draw_page(ra8876_t *dev) { return dev->draw_page; }
+
+uint32_t ra8876_sdram_alloc(ra8876_t *dev, uint16_t rows) {
+    uint32_t bytes = (uint32_t)rows * dev->width * ra8876_pixel_bytes(dev);
+    uint32_t floor = (uint32_t)dev->num_pages * dev->page_size;
+    if (bytes == 0 || dev->sdram_blocks == RA8876_SDRAM_BLOCKS || dev->sdram_top < floor + bytes)
+        return RA8876_SDRAM_NONE;
+    dev->sdram_top -= bytes;
+    dev->max_pages = dev->sdram_top / dev->page_size;
+    dev->sdram_block[dev->sdram_blocks++] = (ra8876_sdram_block_t){ dev->sdram_top, bytes, true };
+    return dev->sdram_top;
+}
+
+void ra8876_sdram_release(ra8876_t *dev, uint32_t addr) {
+    uint8_t i = dev->sdram_blocks;
+    while (i > 0 && !(dev->sdram_block[i - 1].live && dev->sdram_block[i - 1].addr == addr)) i--;
+    if (i == 0) return;
+    dev->sdram_block[i - 1].live = false;
+    while (dev->sdram_blocks > 0 && !dev->sdram_block[dev->sdram_blocks - 1].live)
+        dev->sdram_top += dev->sdram_block[--dev->sdram_blocks].bytes;
+    dev->max_pages = dev->sdram_top / dev->page_size;
+}
+
+static void bte_set_source0(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t x, uint16_t y) {
+    stream_begin(dev);
+    reg_wr32(dev, RA8876_S0_STR, addr);
+    reg_wr16(dev, RA8876_S0_WTH, width);
+    reg_wr16(dev, RA8876_S0_X, x);
+    reg_wr16(dev, RA8876_S0_Y, y);
+    stream_end(dev);
+}
+
+static void bte_set_source1(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t x, uint16_t y) {
+    stream_begin(dev);
+    reg_wr32(dev, RA8876_S1_STR, addr);
+    reg_wr16(dev, RA8876_S1_WTH, width);
+    reg_wr16(dev, RA8876_S1_X, x);
+    reg_wr16(dev, RA8876_S1_Y, y);
+    stream_end(dev);
+}
+
+static void bte_set_dest(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t x, uint16_t y) {
+    stream_begin(dev);
+    reg_wr32(dev, RA8876_DT_STR, addr);
+    reg_wr16(dev, RA8876_DT_WTH, width);
+    reg_wr16(dev, RA8876_DT_X, x);
+    reg_wr16(dev, RA8876_DT_Y, y);
+    stream_end(dev);
+}
+
+static void bte_set_size(ra8876_t *dev, uint16_t width, uint16_t height) {
+    stream_begin(dev);
+    reg_wr16(dev, RA8876_BTE_WTH, width);
+    reg_wr16(dev, RA8876_BTE_HIG, height);
+    stream_end(dev);
+}
+
+static void bte_start(ra8876_t *dev, uint8_t rop, uint8_t op) {
+    reg_wr(dev, RA8876_BTE_COLR, dev->reg92);
+    reg_wr(dev, RA8876_BTE_CTRL1, (rop & 0xF0) | (op & 0x0F));
+    reg_wr(dev, RA8876_BTE_CTRL0, 0x10);
+    while (ra8876_read_reg(dev, RA8876_BTE_CTRL0) & 0x10);
+}
+
+static void bte_start_pattern(ra8876_t *dev, uint8_t rop, uint8_t op, bool p16) {
+    reg_wr(dev, RA8876_BTE_COLR, dev->reg92);
+    reg_wr(dev, RA8876_BTE_CTRL1, (rop & 0xF0) | (op & 0x0F));
+    reg_wr(dev, RA8876_BTE_CTRL0, p16 ? 0x11 : 0x10);
+    while (ra8876_read_reg(dev, RA8876_BTE_CTRL0) & 0x10);
+}
+
+static void bte_start_mpu(ra8876_t *dev, uint8_t rop, uint8_t op) {
+    reg_wr(dev, RA8876_BTE_COLR, dev->reg92);
+    reg_wr(dev, RA8876_BTE_CTRL1, (rop & 0xF0) | (op & 0x0F));
+    reg_wr(dev, RA8876_BTE_CTRL0, 0x10);
+    cmd(dev, RA8876_MRWDP);
+}
+
+static void bte_wait_mpu(ra8876_t *dev) {
+    while (ra8876_read_reg(dev, RA8876_BTE_CTRL0) & 0x10);
+}
+
+static bool clip_bte(ra8876_t *dev, uint32_t dst_addr, int32_t *dst_x, int32_t *dst_y, int32_t *w, int32_t *h,
+                     int32_t *sx0, int32_t *sy0, int32_t *sx1, int32_t *sy1) {
+    int32_t ox = *dst_x, oy = *dst_y;
+    if (!clip_box(dev, dst_addr, dst_x, dst_y, w, h)) return false;
+    if (sx0) {
+        *sx0 += *dst_x - ox;
+        *sy0 += *dst_y - oy;
+    }
+    if (sx1) {
+        *sx1 += *dst_x - ox;
+        *sy1 += *dst_y - oy;
+    }
+    return true;
+}
+
+static void clip_source(int32_t *sx, int32_t *sy, int32_t *dst_x, int32_t *dst_y, int32_t *w, int32_t *h) {
+    if (*sx < 0) {
+        *dst_x -= *sx;
+        *w += *sx;
+        *sx = 0;
+    }
+    if (*sy < 0) {
+        *dst_y -= *sy;
+        *h += *sy;
+        *sy = 0;
+    }
+}
+
+void ra8876_bte_copy_s(ra8876_t *dev, uint32_t src_addr, int32_t src_x, int32_t src_y,
+                       uint32_t dst_addr, int32_t dst_x, int32_t dst_y,
+                       int32_t width, int32_t height, uint8_t rop) {
+    clip_source(&src_x, &src_y, &dst_x, &dst_y, &width, &height);
+    if (!clip_bte(dev, dst_addr, &dst_x, &dst_y, &width, &height, &src_x, &src_y, NULL, NULL)) return;
+    touch(dev, dst_addr, dst_x, dst_y, width, height);
+    ra8876_wait_task_busy(dev);
+    stream_begin(dev);
+    bte_set_source0(dev, src_addr, dev->width, src_x, src_y);
+    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
+    bte_set_size(dev, width, height);
+    bte_start(dev, rop, 0x02);
+    stream_end(dev);
+}
+
+void ra8876_bte_copy(ra8876_t *dev, uint32_t src_addr, uint16_t src_x, uint16_t src_y,
+                     uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
+                     uint16_t width, uint16_t height, uint8_t rop) {
+    ra8876_bte_copy_s(dev, src_addr, src_x, src_y, dst_addr, dst_x, dst_y, width, height, rop);
+}
+
+void ra8876_bte_copy_chroma(ra8876_t *dev, uint32_t src_addr, uint16_t src_x, uint16_t src_y,
+                            uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
+                            uint16_t width, uint16_t height, uint32_t chroma) {
+    int32_t sx = src_x, sy = src_y, dx = dst_x, dy = dst_y, w = width, h = height;
+    if (!clip_bte(dev, dst_addr, &dx, &dy, &w, &h, &sx, &sy, NULL, NULL)) return;
+    touch(dev, dst_addr, dx, dy, w, h);
+    ra8876_wait_task_busy(dev);
+    stream_begin(dev);
+    set_bg_draw_color(dev, chroma);
+    bte_set_source0(dev, src_addr, dev->width, sx, sy);
+    bte_set_dest(dev, dst_addr, dev->width, dx, dy);
+    bte_set_size(dev, w, h);
+    bte_start(dev, RA8876_ROP_S, 0x05);
+    stream_end(dev);
+}
+
+void ra8876_bte_blend(ra8876_t *dev, uint32_t s0_addr, uint16_t s0_x, uint16_t s0_y,
+                      uint32_t s1_addr, uint16_t s1_x, uint16_t s1_y,
+                      uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
+                      uint16_t width, uint16_t height, uint8_t alpha) {
+    int32_t ax = s0_x, ay = s0_y, bx = s1_x, by = s1_y, dx = dst_x, dy = dst_y, w = width, h = height;
+    if (!clip_bte(dev, dst_addr, &dx, &dy, &w, &h, &ax, &ay, &bx, &by)) return;
+    touch(dev, dst_addr, dx, dy, w, h);
+    ra8876_wait_task_busy(dev);
+    stream_begin(dev);
+    bte_set_source0(dev, s0_addr, dev->width, ax, ay);
+    bte_set_source1(dev, s1_addr, dev->width, bx, by);
+    bte_set_dest(dev, dst_addr, dev->width, dx, dy);
+    bte_set_size(dev, w, h);
+    reg_wr(dev, RA8876_APB_CTRL, alpha >> 3);
+    bte_start(dev, RA8876_ROP_S, 0x0A);
+    stream_end(dev);
+}
+
+void ra8876_bte_solid_fill_s(ra8876_t *dev, uint32_t addr, int32_t x, int32_t y,
+                             int32_t width, int32_t height, uint32_t color) {
+    if (!clip_box(dev, addr, &x, &y, &width, &height)) return;
+    touch(dev, addr, x, y, width, height);
+    ra8876_wait_task_busy(dev);
+    stream_begin(dev);
+    set_draw_color(dev, color);
+    bte_set_dest(dev, addr, dev->width, x, y);
+    bte_set_size(dev, width, height);
+    bte_start(dev, RA8876_ROP_S, 0x0C);
+    stream_end(dev);
+}
+
+void ra8876_bte_solid_fill(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                           uint16_t width, uint16_t height, uint32_t color) {
+    ra8876_bte_solid_fill_s(dev, addr, x, y, width, height, color);
+}
+
+void ra8876_bte_batch_start(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t height) {
+    dev->batch_w = addr == dev->canvas_addr ? width : 0;
+    dev->batch_h = height;
+    dev->batch_pos = false;
+    reg_wr32(dev, RA8876_DT_STR, addr);
+    reg_wr16(dev, RA8876_DT_WTH, dev->width);
     bte_set_size(dev, width, height);
-    reg_wr(dev, RA8876_BTE_COLR, 0x00);
+    reg_wr(dev, RA8876_BTE_COLR, dev->reg92);
     reg_wr(dev, RA8876_BTE_CTRL1, (RA8876_ROP_S & 0xF0) | 0x0C);
 }
 
-void ra8876_bte_batch_fill(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color) {
-    reg_wr16(dev, RA8876_DT_X, x);
-    reg_wr16(dev, RA8876_DT_Y, y);
-    set_draw_color(dev, color);
-    reg_wr(dev, RA8876_BTE_CTRL0, 0x10);
-    while (ra8876_read_reg(dev, RA8876_BTE_CTRL0) & 0x10);
+static void batch_coord(ra8876_t *dev, ra8876_reg_t reg, uint16_t old, uint16_t val) {
+    uint16_t diff = old ^ val;
+    if (!dev->batch_pos || (diff & 0x00FF)) reg_wr(dev, reg, val & 0xFF);
+    if (!dev->batch_pos || (diff & 0xFF00)) reg_wr(dev, (ra8876_reg_t)(reg + 1), val >> 8);
+}
+
+void ra8876_bte_batch_fill(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color) {
+    int32_t cx = x, cy = y, w = dev->batch_w, h = dev->batch_h;
+    if (dev->batch_w && !clip_box(dev, dev->canvas_addr, &cx, &cy, &w, &h)) return;
+    if (dev->batch_w) touch(dev, dev->canvas_addr, cx, cy, w, h);
+    bool trimmed = dev->batch_w && (w != dev->batch_w || h != dev->batch_h);
+    if (trimmed) bte_set_size(dev, w, h);
+    batch_coord(dev, RA8876_DT_X, dev->batch_x, cx);
+    batch_coord(dev, RA8876_DT_Y, dev->batch_y, cy);
+    dev->batch_x = cx;
+    dev->batch_y = cy;
+    dev->batch_pos = true;
+    set_draw_color(dev, color);
+    reg_wr(dev, RA8876_BTE_CTRL0, 0x10);
+    while (ra8876_read_reg(dev, RA8876_BTE_CTRL0) & 0x10);
+    if (trimmed) bte_set_size(dev, dev->batch_w, dev->batch_h);
+}
+
+static void bte_write_open(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+    touch(dev, addr, x, y, width, height);
+    ra8876_wait_task_busy(dev);
+    bte_set_dest(dev, addr, dev->width, x, y);
+    bte_set_size(dev, width, height);
+    bte_start_mpu(dev, RA8876_ROP_S, 0x00);
+    while (ra8876_read_status(dev) & 0x80);
+}
+
+static void stream_rows(ra8876_t *dev, const uint8_t *data, uint32_t row_bytes,
+                        int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t full_w) {
+    uint8_t pb = ra8876_pixel_bytes(dev);
+    if ((uint32_t)w == full_w) {
+        ra8876_write_data_burst(dev, data + oy * row_bytes, (size_t)h * row_bytes);
+        return;
+    }
+    for (int32_t r = 0; r < h; r++)
+        ra8876_write_data_burst(dev, data + (oy + r) * row_bytes + ox * pb, (size_t)w * pb);
+}
+
+void ra8876_bte_write_begin(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                            uint16_t width, uint16_t height) {
+    int32_t cx = x, cy = y, w = width, h = height;
+    uint8_t pb = ra8876_pixel_bytes(dev);
+    dev->wr_clip = false;
+    if (!clip_box(dev, addr, &cx, &cy, &w, &h)) {
+        dev->wr_clip = true;
+        dev->wr_row0 = dev->wr_row1 = 0;
+        return;
+    }
+    if (w != width || h != height) {
+        dev->wr_clip = true;
+        dev->wr_row_bytes = (uint32_t)width * pb;
+        dev->wr_pos = 0;
+        dev->wr_row = 0;
+        dev->wr_vis0 = (uint32_t)(cx - x) * pb;
+        dev->wr_vis1 = dev->wr_vis0 + (uint32_t)w * pb;
+        dev->wr_row0 = cy - y;
+        dev->wr_row1 = cy - y + h;
+    }
+    bte_write_open(dev, addr, cx, cy, w, h);
+}
+
+void ra8876_bte_write_data(ra8876_t *dev, const uint8_t *data, size_t len) {
+    if (!dev->wr_clip) {
+        ra8876_write_data_burst(dev, data, len);
+        return;
+    }
+    while (len > 0 && dev->wr_row < dev->wr_row1) {
+        uint32_t n = dev->wr_row_bytes - dev->wr_pos;
+        if (n > len) n = len;
+        if (dev->wr_row >= dev->wr_row0) {
+            uint32_t a = dev->wr_pos > dev->wr_vis0 ? dev->wr_pos : dev->wr_vis0;
+            uint32_t b = dev->wr_pos + n < dev->wr_vis1 ? dev->wr_pos + n : dev->wr_vis1;
+            if (a < b) ra8876_write_data_burst(dev, data + (a - dev->wr_pos), b - a);
+        }
+        data += n;
+        len -= n;
+        dev->wr_pos += n;
+        if (dev->wr_pos == dev->wr_row_bytes) {
+            dev->wr_pos = 0;
+            dev->wr_row++;
+        }
+    }
+}
+
+void ra8876_bte_write_end(ra8876_t *dev) {
+    bool culled = dev->wr_clip && dev->wr_row1 == 0;
+    dev->wr_clip = false;
+    if (!culled) bte_wait_mpu(dev);
+}
+
+void ra8876_bte_write_gen(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                          uint16_t width, uint16_t height, ra8876_span_fn fn, void *ctx) {
+    uint8_t buf[RA8876_BURST_SIZE];
+    uint8_t pb = ra8876_pixel_bytes(dev);
+    uint16_t sx = 0, sy = 0;
+    int32_t cx = x, cy = y, cw = width, ch = height;
+
+    if (!clip_box(dev, addr, &cx, &cy, &cw, &ch)) return;
+    uint16_t ox = cx - x, oy = cy - y;
+    width = cw;
+    height = ch;
+    bte_write_open(dev, addr, cx, cy, width, height);
+    while (sy < height) {
+        uint16_t len = width - sx;
+        if (len > RA8876_BURST_SIZE / pb) len = RA8876_BURST_SIZE / pb;
+        fn(ctx, ox + sx, oy + sy, len, buf);
+        sx += len;
+        if (sx == width) {
+            sx = 0;
+            sy++;
+        }
+        ra8876_write_data_burst(dev, buf, (size_t)len * pb);
+    }
+    bte_wait_mpu(dev);
+}
+
+void ra8876_bte_write(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                      uint16_t width, uint16_t height, const uint8_t *data) {
+    ra8876_bte_write_begin(dev, addr, x, y, width, height);
+    ra8876_bte_write_data(dev, data, (size_t)width * height * ra8876_pixel_bytes(dev));
+    ra8876_bte_write_end(dev);
+}
+
+void ra8876_bte_write_chroma(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                             uint16_t width, uint16_t height,
+                             const uint8_t *data, uint32_t chroma) {
+    int32_t cx = x, cy = y, w = width, h = height;
+    if (!clip_box(dev, addr, &cx, &cy, &w, &h)) return;
+    touch(dev, addr, cx, cy, w, h);
+    ra8876_wait_task_busy(dev);
+    set_bg_draw_color(dev, chroma);
+    bte_set_dest(dev, addr, dev->width, cx, cy);
+    bte_set_size(dev, w, h);
+    bte_start_mpu(dev, RA8876_ROP_S, 0x04);
+    while (ra8876_read_status(dev) & 0x80);
+    stream_rows(dev, data, (uint32_t)width * ra8876_pixel_bytes(dev), cx - x, cy - y, w, h, width);
+    bte_wait_mpu(dev);
+}
+
+static void stream_bits(ra8876_t *dev, const uint8_t *bitmap, uint16_t full_w,
+                        int32_t ox, int32_t oy, int32_t w, int32_t h) {
+    size_t row_bytes = (full_w + 7) / 8, out_bytes = (w + 7) / 8;
+    if (w == full_w) {
+        ra8876_write_data_burst(dev, bitmap + oy * row_bytes, row_bytes * h);
+        return;
+    }
+    uint8_t shift = ox & 7;
+    uint8_t buf[32];
+    for (int32_t r = 0; r < h; r++) {
+        const uint8_t *src = bitmap + (oy + r) * row_bytes + ox / 8;
+        if (shift == 0) {
+            ra8876_write_data_burst(dev, src, out_bytes);
+            continue;
+        }
+        for (size_t i = 0; i < out_bytes; i += sizeof(buf)) {
+            size_t n = out_bytes - i < sizeof(buf) ? out_bytes - i : sizeof(buf);
+            for (size_t k = 0; k < n; k++) {
+                uint8_t lo = ox / 8 + i + k + 1 < row_bytes ? src[i + k + 1] : 0;
+                buf[k] = (uint8_t)((src[i + k] << shift) | (lo >> (8 - shift)));
+            }
+            ra8876_write_data_burst(dev, buf, n);
+        }
+    }
+}
+
+void ra8876_bte_expand(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                       uint16_t width, uint16_t height,
+                       const uint8_t *bitmap, uint32_t fg, uint32_t bg) {
+    int32_t cx = x, cy = y, w = width, h = height;
+    if (!clip_box(dev, addr, &cx, &cy, &w, &h)) return;
+    touch(dev, addr, cx, cy, w, h);
+    ra8876_wait_task_busy(dev);
+    set_draw_color(dev, fg);
+    set_bg_draw_color(dev, bg);
+    bte_set_dest(dev, addr, dev->width, cx, cy);
+    bte_set_size(dev, w, h);
+    bte_start_mpu(dev, RA8876_ROP_S, 0x08);
+    while (ra8876_read_status(dev) & 0x80);
+    stream_bits(dev, bitmap, width, cx - x, cy - y, w, h);
+    bte_wait_mpu(dev);
+}
+
+void ra8876_bte_expand_chroma(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                              uint16_t width, uint16_t height,
+                              const uint8_t *bitmap, uint32_t fg) {
+    int32_t cx = x, cy = y, w = width, h = height;
+    if (!clip_box(dev, addr, &cx, &cy, &w, &h)) return;
+    touch(dev, addr, cx, cy, w, h);
+    ra8876_wait_task_busy(dev);
+    set_draw_color(dev, fg);
+    bte_set_dest(dev, addr, dev->width, cx, cy);
+    bte_set_size(dev, w, h);
+    bte_start_mpu(dev, RA8876_ROP_S, 0x09);
+    while (ra8876_read_status(dev) & 0x80);
+    stream_bits(dev, bitmap, width, cx - x, cy - y, w, h);
+    bte_wait_mpu(dev);
+}
+
+void ra8876_bte_mem_expand(ra8876_t *dev, uint32_t src_addr, uint16_t src_x, uint16_t src_y,
+                           uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
+                           uint16_t width, uint16_t height, uint32_t fg, uint32_t bg) {
+    if (!ra8876_clip_visible(dev, dst_x, dst_y, width, height) && dst_addr == dev->canvas_addr) {
+        dev->ops_culled++;
+        return;
+    }
+    dev->ops_submitted++;
+    touch(dev, dst_addr, dst_x, dst_y, width, height);
+    ra8876_wait_task_busy(dev);
+    set_draw_color(dev, fg);
+    set_bg_draw_color(dev, bg);
+    bte_set_source0(dev, src_addr, dev->width, src_x, src_y);
+    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
+    bte_set_size(dev, width, height);
+    bte_start(dev, RA8876_ROP_S, 0x0E);
+}
+
+void ra8876_bte_write_opacity(ra8876_t *dev, uint32_t s1_addr, uint16_t s1_x, uint16_t s1_y,
+                              uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
+                              uint16_t width, uint16_t height,
+                              const uint8_t *data, uint8_t alpha) {
+    int32_t sx = s1_x, sy = s1_y, dx = dst_x, dy = dst_y, w = width, h = height;
+    if (!clip_bte(dev, dst_addr, &dx, &dy, &w, &h, &sx, &sy, NULL, NULL)) return;
+    touch(dev, dst_addr, dx, dy, w, h);
+    ra8876_wait_task_busy(dev);
+    bte_set_source1(dev, s1_addr, dev->width, sx, sy);
+    bte_set_dest(dev, dst_addr, dev->width, dx, dy);
+    bte_set_size(dev, w, h);
+    reg_wr(dev, RA8876_APB_CTRL, alpha >> 3);
+    bte_start_mpu(dev, RA8876_ROP_S, 0x0B);
+    while (ra8876_read_status(dev) & 0x80);
+    stream_rows(dev, data, (uint32_t)width * ra8876_pixel_bytes(dev), dx - dst_x, dy - dst_y, w, h, width);
+    bte_wait_mpu(dev);
+}
+
+static void pattern_fill(ra8876_t *dev, uint32_t pattern_addr, uint16_t pattern_width,
+                         uint32_t dst_addr, int32_t x, int32_t y, int32_t w, int32_t h,
+                         bool pattern_16x16, uint8_t rop) {
+    if (!clip_box(dev, dst_addr, &x, &y, &w, &h)) return;
+    touch(dev, dst_addr, x, y, w, h);
+    ra8876_wait_task_busy(dev);
+    stream_begin(dev);
+    bte_set_source0(dev, pattern_addr, pattern_width, 0, 0);
+    bte_set_dest(dev, dst_addr, dev->width, x, y);
+    bte_set_size(dev, w, h);
+    bte_start_pattern(dev, rop, 0x06, pattern_16x16);
+    stream_end(dev);
+}
+
+void ra8876_bte_pattern_fill(ra8876_t *dev, uint32_t pattern_addr,
+                             uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
+                             uint16_t width, uint16_t height,
+                             bool pattern_16x16, uint8_t rop) {
+    pattern_fill(dev, pattern_addr, dev->width, dst_addr, dst_x, dst_y, width, height, pattern_16x16, rop);
+}
+
+bool ra8876_pattern_cache_init(ra8876_t *dev, ra8876_pattern_cache_t *cache, uint8_t slots) {
+    if (slots > RA8876_PATTERN_MAX) slots = RA8876_PATTERN_MAX;
+    uint32_t row_bytes = (uint32_t)dev->width * ra8876_pixel_bytes(dev);
+    cache->slot_bytes = 16 * 16 * ra8876_pixel_bytes(dev);
+    cache->rows = ((uint32_t)slots * cache->slot_bytes + row_bytes - 1) / row_bytes;
+    cache->addr = ra8876_sdram_alloc(dev, cache->rows);
+    cache->pixel_bytes = ra8876_pixel_bytes(dev);
+    cache->slots = cache->addr == RA8876_SDRAM_NONE ? 0 : slots;
+    cache->used = 0;
+    memset(cache->size, 0, sizeof(cache->size));
+    return cache->addr != RA8876_SDRAM_NONE;
+}
+
+void ra8876_pattern_cache_free(ra8876_t *dev, ra8876_pattern_cache_t *cache) {
+    if (cache->addr == RA8876_SDRAM_NONE) return;
+    ra8876_wait_task_busy(dev);
+    ra8876_sdram_release(dev, cache->addr);
+    cache->addr = RA8876_SDRAM_NONE;
+    cache->rows = 0;
+    cache->slots = 0;
+    cache->used = 0;
+    memset(cache->size, 0, sizeof(cache->size));
+}
+
+static uint32_t pattern_addr(const ra8876_pattern_cache_t *cache, int8_t handle) {
+    return cache->addr + (uint32_t)handle * cache->slot_bytes;
+}
+
+int8_t ra8876_pattern_add(ra8876_t *dev, ra8876_pattern_cache_t *cache, const uint8_t *pixels, uint8_t size) {
+    if ((size != 8 && size != 16) || cache->pixel_bytes != ra8876_pixel_bytes(dev)) return RA8876_PATTERN_NONE;
+    int8_t handle = 0;
+    while (handle < cache->slots && cache->size[handle]) handle++;
+    if (handle == cache->slots) return RA8876_PATTERN_NONE;
+
+    ra8876_wait_task_busy(dev);
+    reg_wr(dev, RA8876_AW_COLOR, 0x04);
+    reg_wr32(dev, RA8876_CURH, pattern_addr(cache, handle));
+    cmd(dev, RA8876_MRWDP);
+    while (ra8876_read_status(dev) & 0x80);
+    ra8876_write_data_burst(dev, pixels, (size_t)size * size * ra8876_pixel_bytes(dev));
+    ra8876_wait_write_fifo_empty(dev);
+    ra8876_wait_task_busy(dev);
+    reg_wr(dev, RA8876_AW_COLOR, dev->reg5E);
+    cmd(dev, RA8876_CHIP_ID);
+
+    cache->size[handle] = size;
+    cache->used++;
+    return handle;
+}
+
+int8_t ra8876_pattern_add_mono(ra8876_t *dev, ra8876_pattern_cache_t *cache, const uint8_t *bits, uint8_t size,
+                               uint32_t fg, uint32_t bg) {
+    if (size != 8 && size != 16) return RA8876_PATTERN_NONE;
+    uint8_t pixels[16 * 16 * 3];
+    uint8_t *out = pixels;
+    for (uint8_t y = 0; y < size; y++)
+        for (uint8_t x = 0; x < size; x++) {
+            bool on = bits[y * (size / 8) + x / 8] & (0x80 >> (x & 7));
+            out += ra8876_put_pixel(dev, out, on ? fg : bg);
+        }
+    return ra8876_pattern_add(dev, cache, pixels, size);
+}
+
+void ra8876_pattern_remove(ra8876_pattern_cache_t *cache, int8_t handle) {
+    if (handle < 0 || handle >= cache->slots || !cache->size[handle]) return;
+    cache->size[handle] = 0;
+    cache->used--;
+}
+
+void ra8876_pattern_fill(ra8876_t *dev, const ra8876_pattern_cache_t *cache, int8_t handle,
+                         uint32_t dst_addr, int32_t x, int32_t y, int32_t width, int32_t height, uint8_t rop) {
+    if (handle < 0 || handle >= cache->slots || !cache->size[handle]) return;
+    if (cache->pixel_bytes != ra8876_pixel_bytes(dev)) return;
+    uint8_t size = cache->size[handle];
+    pattern_fill(dev, pattern_addr(cache, handle), size, dst_addr, x, y, width, height, size == 16, rop);
+}
+
+void ra8876_cursor_show(ra8876_t *dev, bool blink) {
+    dev->reg3C = (dev->reg3C & ~0x03) | 0x02 | (blink ? 0x01 : 0x00);
+    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+}
+
+void ra8876_cursor_hide(ra8876_t *dev) {
+    dev->reg3C &= ~0x03;
+    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+}
+
+void ra8876_cursor_size(ra8876_t *dev, uint8_t width, uint8_t height) {
+    reg_wr(dev, RA8876_CURHS, width - 1);
+    reg_wr(dev, RA8876_CURVS, height - 1);
+}
+
+void ra8876_cursor_blink_rate(ra8876_t *dev, uint8_t frames) {
+    reg_wr(dev, RA8876_BTCR, frames);
+}
+
+void ra8876_gcursor_enable(ra8876_t *dev, uint8_t set) {
+    dev->reg3C = (dev->reg3C & ~0x1C) | 0x10 | ((set & 0x03) << 2);
+    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+}
+
+void ra8876_gcursor_disable(ra8876_t *dev) {
+    dev->reg3C &= ~0x10;
+    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+}
+
+void ra8876_gcursor_move(ra8876_t *dev, uint16_t x, uint16_t y) {
+    reg_wr16(dev, RA8876_GCHP, x);
+    reg_wr16(dev, RA8876_GCVP, y);
+}
+
+void ra8876_gcursor_colors(ra8876_t *dev, uint8_t color0, uint8_t color1) {
+    reg_wr(dev, RA8876_GCC0, color0);
+    reg_wr(dev, RA8876_GCC1, color1);
+}
+
+void ra8876_gcursor_load(ra8876_t *dev, uint8_t set, const uint8_t *data) {
+    dev->reg3C = (dev->reg3C & ~0x0C) | ((set & 0x03) << 2);
+    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+    dev->reg03 = (dev->reg03 & ~0x03) | 0x02;
+    reg_wr(dev, RA8876_ICR, dev->reg03);
+    cmd(dev, RA8876_MRWDP);
+    ra8876_write_data_burst(dev, data, 256);
+    dev->reg03 &= ~0x03;
+    reg_wr(dev, RA8876_ICR, dev->reg03);
+}
+
+void ra8876_invert_area(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    uint32_t addr = dev->canvas_addr;
+    int32_t cx = x, cy = y, cw = w, ch = h;
+    if (!clip_box(dev, addr, &cx, &cy, &cw, &ch)) return;
+    touch(dev, addr, cx, cy, cw, ch);
+    ra8876_wait_task_busy(dev);
+    bte_set_source0(dev, addr, dev->width, cx, cy);
+    bte_set_dest(dev, addr, dev->width, cx, cy);
+    bte_set_size(dev, cw, ch);
+    bte_start(dev, RA8876_ROP_NOT_S, 0x02);
+}
+
+void ra8876_pip1_enable(ra8876_t *dev, uint32_t src_addr, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    dev->reg10 &= ~0x10;
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+    reg_wr32(dev, RA8876_PISA, src_addr);
+    reg_wr16(dev, RA8876_PIW, dev->width);
+    reg_wr16(dev, RA8876_PWDULX, x);
+    reg_wr16(dev, RA8876_PWDULY, y);
+    reg_wr16(dev, RA8876_PWIULX, 0);
+    reg_wr16(dev, RA8876_PWIULY, 0);
+    reg_wr16(dev, RA8876_PWW, w);
+    reg_wr16(dev, RA8876_PWH, h);
+    dev->reg10 |= 0x80;
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+}
+
+void ra8876_pip1_move(ra8876_t *dev, uint16_t x, uint16_t y) {
+    dev->reg10 &= ~0x10;
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+    reg_wr16(dev, RA8876_PWDULX, x);
+    reg_wr16(dev, RA8876_PWDULY, y);
+}
+
+void ra8876_pip1_disable(ra8876_t *dev) {
+    dev->reg10 &= ~0x80;
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+}
+
+void ra8876_pip2_enable(ra8876_t *dev, uint32_t src_addr, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    dev->reg10 |= 0x10;
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+    reg_wr32(dev, RA8876_PISA, src_addr);
+    reg_wr16(dev, RA8876_PIW, dev->width);
+    reg_wr16(dev, RA8876_PWDULX, x);
+    reg_wr16(dev, RA8876_PWDULY, y);
+    reg_wr16(dev, RA8876_PWIULX, 0);
+    reg_wr16(dev, RA8876_PWIULY, 0);
+    reg_wr16(dev, RA8876_PWW, w);
+    reg_wr16(dev, RA8876_PWH, h);
+    dev->reg10 |= 0x40;
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+}
+
+void ra8876_pip2_move(ra8876_t *dev, uint16_t x, uint16_t y) {
+    dev->reg10 |= 0x10;
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+    reg_wr16(dev, RA8876_PWDULX, x);
+    reg_wr16(dev, RA8876_PWDULY, y);
+}
+
+void ra8876_pip2_disable(ra8876_t *dev) {
+    dev->reg10 &= ~0x40;
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+}
+
+void ra8876_pip_set_depth(ra8876_t *dev, uint8_t pip, uint8_t bpp) {
+    if (pip == 1)
+        dev->reg11 = (dev->reg11 & ~0x0C) | (depth_code(bpp) << 2);
+    else
+        dev->reg11 = (dev->reg11 & ~0x03) | depth_code(bpp);
+    reg_wr(dev, RA8876_PIPCDEP, dev->reg11);
+}
+
+void ra8876_bte_set_source_depth(ra8876_t *dev, uint8_t s0_bpp, uint8_t s1_bpp) {
+    dev->reg92 = (depth_code(s0_bpp) << 5) | (depth_code(s1_bpp) << 2) | depth_code(dev->bpp);
+}
+
+bool ra8876_set_color_depth(ra8876_t *dev, uint8_t bpp) {
+    if (bpp != 8 && bpp != 16 && bpp != 24) return false;
+    ra8876_wait_task_busy(dev);
+    if (dev->aa_addr != RA8876_SDRAM_NONE) {
+        ra8876_sdram_release(dev, dev->aa_addr);
+        dev->aa_addr = RA8876_SDRAM_NONE;
+    }
+    dev->bpp = bpp;
+    dev->page_size = (uint32_t)dev->width * dev->height * ra8876_pixel_bytes(dev);
+    dev->max_pages = dev->sdram_top / dev->page_size;
+    dev->reg10 = (dev->reg10 & ~0x0C) | (depth_code(bpp) << 2);
+    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+    dev->reg11 = (depth_code(bpp) << 2) | depth_code(bpp);
+    reg_wr(dev, RA8876_PIPCDEP, dev->reg11);
+    dev->reg5E = (dev->reg5E & ~0x03) | depth_code(bpp);
+    reg_wr(dev, RA8876_AW_COLOR, dev->reg5E);
+    dev->reg92 = (depth_code(bpp) << 5) | (depth_code(bpp) << 2) | depth_code(bpp);
+    dev->num_pages = 1;
+    dev->draw_page = 0;
+    dev->display_page = 0;
+    ra8876_set_display_addr(dev, 0);
+    ra8876_set_canvas_addr(dev, 0);
+    return true;
+}
+
+void ra8876_cgram_init(ra8876_t *dev) {
+    reg_wr32(dev, RA8876_CGRAM_STR, cgram_addr(dev));
+}
+
+void ra8876_cgram_upload_font(ra8876_t *dev, const uint8_t *data, uint8_t first_char, uint8_t num_chars, uint8_t font_height) {
+    uint32_t bytes_per_char;
+    switch (font_height) {
+        case 24: bytes_per_char = 48; break;
+        case 32: bytes_per_char = 64; break;
+        default: bytes_per_char = 16; break;
+    }
+
+    uint32_t addr = cgram_addr(dev) + first_char * bytes_per_char;
+    uint32_t total = num_chars * bytes_per_char;
+
+    ra8876_wait_task_busy(dev);
+    reg_wr(dev, RA8876_AW_COLOR, 0x04);
+    reg_wr32(dev, RA8876_CURH, addr);
+    cmd(dev, RA8876_MRWDP);
+
+    while (ra8876_read_status(dev) & 0x80);
+    ra8876_write_data_burst(dev, data, total);
+
+    ra8876_wait_write_fifo_empty(dev);
+    ra8876_wait_task_busy(dev);
+    reg_wr(dev, RA8876_AW_COLOR, dev->reg5E);
+    cmd(dev, RA8876_CHIP_ID);
+}
+
+void ra8876_cgram_upload_inv_font(ra8876_t *dev, const uint8_t *data, uint8_t first_char, uint8_t num_chars, uint8_t font_height) {
+    uint32_t bytes_per_char;
+    switch (font_height) {
+        case 24: bytes_per_char = 48; break;
+        case 32: bytes_per_char = 64; break;
+        default: bytes_per_char = 16; break;
+    }
+
+    uint32_t addr = cgram_addr(dev) + (256 + first_char) * bytes_per_char;
+
+    ra8876_wait_task_busy(dev);
+    reg_wr(dev, RA8876_AW_COLOR, 0x04);
+    reg_wr32(dev, RA8876_CURH, addr);
+    cmd(dev, RA8876_MRWDP);
+
+    while (ra8876_read_status(dev) & 0x80);
+
+    uint8_t inv[64];
+    for (uint8_t c = 0; c < num_chars; c++) {
+        for (uint32_t i = 0; i < bytes_per_char; i++)
+            inv[i] = ~data[c * bytes_per_char + i];
+        ra8876_write_data_burst(dev, inv, bytes_per_char);
+    }
+
+    ra8876_wait_write_fifo_empty(dev);
+    ra8876_wait_task_busy(dev);
+    reg_wr(dev, RA8876_AW_COLOR, dev->reg5E);
+    cmd(dev, RA8876_CHIP_ID);
+}
+
+void ra8876_cgram_upload_cursor_font(ra8876_t *dev, const uint8_t *data, uint8_t first_char, uint8_t num_chars, uint8_t font_height) {
+    uint32_t bytes_per_char;
+    switch (font_height) {
+        case 24: bytes_per_char = 48; break;
+        case 32: bytes_per_char = 64; break;
+        default: bytes_per_char = 16; break;
+    }
+
+    uint32_t addr = cgram_addr(dev) + (512 + first_char) * bytes_per_char;
+
+    ra8876_wait_task_busy(dev);
+    reg_wr(dev, RA8876_AW_COLOR, 0x04);
+    reg_wr32(dev, RA8876_CURH, addr);
+    cmd(dev, RA8876_MRWDP);
+
+    while (ra8876_read_status(dev) & 0x80);
+
+    uint8_t buf[64];
+    for (uint8_t c = 0; c < num_chars; c++) {
+        buf[0] = 0xFF;
+        buf[1] = 0x00;
+        for (uint32_t i = 2; i < bytes_per_char - 2; i++)
+            buf[i] = ~data[c * bytes_per_char + i];
+        buf[bytes_per_char - 2] = 0x00;
+        buf[bytes_per_char - 1] = 0xFF;
+        ra8876_write_data_burst(dev, buf, bytes_per_char);
+    }
+
+    ra8876_wait_write_fifo_empty(dev);
+    ra8876_wait_task_busy(dev);
+    reg_wr(dev, RA8876_AW_COLOR, dev->reg5E);
+    cmd(dev, RA8876_CHIP_ID);
+}
+
+void ra8876_select_cgram_font(ra8876_t *dev, uint8_t size) {
+    switch (size) {
+        case RA8876_FONT_24: dev->char_width = 12; dev->char_height = 24; break;
+        case RA8876_FONT_32: dev->char_width = 16; dev->char_height = 32; break;
+        default: dev->char_width = 8; dev->char_height = 16; break;
+    }
+    reg_wr32(dev, RA8876_CGRAM_STR, cgram_addr(dev));
+    dev->regCC = 0x80 | ((size & 0x03) << 4);
+    reg_wr(dev, RA8876_CCR0, dev->regCC);
+}
+
+void ra8876_put_cgram_string_off(ra8876_t *dev, const char *str, uint8_t offset) {
+    text_sync(dev);
+    touch_text(dev, strlen(str));
+    dev->text_x = RA8876_UNKNOWN_POS;
+    ra8876_set_text_mode(dev);
+    cmd(dev, RA8876_MRWDP);
+    uint8_t buf[64];
+    while (*str) {
+        size_t n = 0;
+        while (*str && n < 64) {
+            buf[n++] = offset;
+            buf[n++] = *str++;
+        }
+        ra8876_write_data_burst(dev, buf, n);
+    }
+    ra8876_set_graphics_mode(dev);
+}
+
+void ra8876_put_cgram_string(ra8876_t *dev, const char *str) {
+    ra8876_put_cgram_string_off(dev, str, 0);
+}
+
+static int16_t chart_map(ra8876_chart_t *c, int16_t v) {
+    int32_t span = (int32_t)c->hi - c->lo;
+    if (span <= 0) span = 1;
+    int32_t y = (int32_t)(c->h - 1) - ((int32_t)v - c->lo) * (c->h - 1) / span;
+    if (y < 0) y = 0;
+    if (y > c->h - 1) y = c->h - 1;
+    return y;
+}
+
+static int16_t chart_sample(ra8876_chart_t *c, uint32_t n, uint8_t t) {
+    return c->history[(n % c->w) * c->num_traces + t];
+}
+
+static void chart_fit(ra8876_chart_t *c) {
+    uint32_t count = c->total < c->w ? c->total : c->w;
+    if (count == 0) return;
+    int16_t lo = INT16_MAX, hi = INT16_MIN;
+    for (uint32_t i = 0; i < count * c->num_traces; i++) {
+        uint32_t n = c->total - count + i / c->num_traces;
+        int16_t v = chart_sample(c, n, i % c->num_traces);
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+    int32_t margin = ((int32_t)hi - lo) / 8 + 1;
+    int32_t new_lo = (int32_t)lo - margin, new_hi = (int32_t)hi + margin;
+    c->lo = new_lo < INT16_MIN ? INT16_MIN : new_lo;
+    c->hi = new_hi > INT16_MAX ? INT16_MAX : new_hi;
+    c->redraw = true;
+}
+
+bool ra8876_chart_init(ra8876_t *dev, ra8876_chart_t *c, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                       int16_t *history, uint8_t num_traces, const uint32_t *colors) {
+    if (num_traces < 1 || num_traces > RA8876_CHART_MAX_TRACES || w == 0 || w > dev->width || h < 2)
+        return false;
+    c->ring_addr = ra8876_sdram_alloc(dev, h);
+    if (c->ring_addr == RA8876_SDRAM_NONE) return false;
+    c->x = x;
+    c->y = y;
+    c->w = w;
+    c->h = h;
+    c->history = history;
+    c->num_traces = num_traces;
+    for (uint8_t t = 0; t < num_traces; t++)
+        c->colors[t] = colors[t];
+    c->bg = RA8876_BLACK;
+    c->grid = RA8876_DARKGRAY;
+    c->grid_step = 0;
+    c->lo = 0;
+    c->hi = h - 1;
+    c->autoscale = true;
+    c->total = 0;
+    c->pending = 0;
+    c->redraw = true;
+    return true;
+}
+
+void ra8876_chart_set_colors(ra8876_chart_t *c, uint32_t bg, uint32_t grid, uint16_t grid_step) {
+    c->bg = bg;
+    c->grid = grid;
+    c->grid_step = grid_step;
+    c->redraw = true;
+}
+
+void ra8876_chart_set_range(ra8876_chart_t *c, int16_t lo, int16_t hi) {
+    c->lo = lo;
+    c->hi = hi;
+    c->autoscale = false;
+    c->redraw = true;
+}
+
+void ra8876_chart_set_autoscale(ra8876_chart_t *c, bool enable) {
+    c->autoscale = enable;
+    if (enable) chart_fit(c);
+}
+
+void ra8876_chart_push(ra8876_chart_t *c, const int16_t *samples) {
+    bool refit = false;
+    int16_t *slot = &c->history[(c->total % c->w) * c->num_traces];
+    for (uint8_t t = 0; t < c->num_traces; t++) {
+        slot[t] = samples[t];
+        if (samples[t] < c->lo || samples[t] > c->hi) refit = true;
+    }
+    c->total++;
+    if (c->pending < c->w) c->pending++;
+    if (c->autoscale) {
+        if (refit) {
+            chart_fit(c);
+        } else if (c->total % c->w == 0) {
+            int16_t lo = c->lo, hi = c->hi;
+            bool redraw = c->redraw;
+            chart_fit(c);
+            if (((int32_t)c->hi - c->lo) * 2 > ((int32_t)hi - lo)) {
+                c->lo = lo;
+                c->hi = hi;
+                c->redraw = redraw;
+            }
+        }
+    }
+}
+
+static void chart_draw_columns(ra8876_t *dev, ra8876_chart_t *c, uint32_t first, uint16_t count) {
+    uint16_t col = first % c->w;
+    ra8876_fill_rect(dev, col, 0, count, c->h, c->bg);
+    if (c->grid_step) {
+        for (uint16_t gy = c->grid_step; gy < c->h; gy += c->grid_step)
+            ra8876_draw_line(dev, col, gy, col + count - 1, gy, c->grid);
+        for (uint32_t n = first; n < first + count; n++) {
+            if (n % c->grid_step == 0)
+                ra8876_draw_line(dev, n % c->w, 0, n % c->w, c->h - 1, c->grid);
+        }
+    }
+
+    ra8876_point_t pts[RA8876_CHART_SEGMENT + 1];
+    for (uint8_t t = 0; t < c->num_traces; t++) {
+        uint32_t n = first;
+        while (n < first + count) {
+            uint16_t k = 0;
+            if (n > 0 && n + c->w > c->total) {
+                pts[k].x = (n % c->w) ? (n % c->w) - 1 : 0;
+                pts[k].y = chart_map(c, chart_sample(c, n - 1, t));
+                k++;
+            }
+            while (k <= RA8876_CHART_SEGMENT && n < first + count) {
+                pts[k].x = n % c->w;
+                pts[k].y = chart_map(c, chart_sample(c, n, t));
+                k++;
+                n++;
+            }
+            if (k == 1) {
+                pts[1] = pts[0];
+                k = 2;
+            }
+            ra8876_draw_polyline(dev, pts, k, c->colors[t]);
+        }
+    }
+}
+
+void ra8876_chart_update(ra8876_t *dev, ra8876_chart_t *c, uint32_t dst_addr) {
+    uint32_t first = c->total - c->pending;
+    uint16_t count = c->pending;
+    if (c->redraw) {
+        count = c->w;
+        first = c->total > c->w ? c->total - c->w : 0;
+    }
+
+    if (count > 0) {
+        uint32_t canvas = dev->canvas_addr;
+        ra8876_rect_t saved;
+        clip_suspend(dev, &saved);
+        ra8876_set_canvas_addr(dev, c->ring_addr);
+        if (c->redraw && c->total < c->w)
+            ra8876_fill_rect(dev, 0, 0, c->w, c->h, c->bg);
+        while (count > 0) {
+            uint16_t run = c->w - first % c->w;
+            if (run > count) run = count;
+            chart_draw_columns(dev, c, first, run);
+            first += run;
+            count -= run;
+        }
+        ra8876_set_canvas_addr(dev, canvas);
+        clip_resume(dev, &saved);
+        c->pending = 0;
+        c->redraw = false;
+    }
+
+    uint16_t head = c->total % c->w;
+    if (c->total < c->w) head = 0;
+    if (head < c->w)
+        ra8876_bte_copy(dev, c->ring_addr, head, 0, dst_addr, c->x, c->y, c->w - head, c->h, RA8876_ROP_S);
+    if (head > 0)
+        ra8876_bte_copy(dev, c->ring_addr, 0, 0, dst_addr, c->x + c->w - head, c->y, head, c->h, RA8876_ROP_S);
+}
+
+bool ra8876_rle_info(const uint8_t *blob, size_t size, ra8876_rle_info_t *info) {
+    if (size < RA8876_RLE_HEADER) return false;
+    if (memcmp(blob, RA8876_RLE_MAGIC, 4) != 0) return false;
+    info->width = blob[4] | (blob[5] << 8);
+    info->height = blob[6] | (blob[7] << 8);
+    info->pixel_bytes = blob[8];
+    return info->pixel_bytes >= 1 && info->pixel_bytes <= 3 && info->width > 0 && info->height > 0;
+}
+
+size_t ra8876_rle_write_header(uint8_t *out, uint16_t width, uint16_t height, uint8_t pixel_bytes) {
+    memcpy(out, RA8876_RLE_MAGIC, 4);
+    out[4] = width & 0xFF;
+    out[5] = width >> 8;
+    out[6] = height & 0xFF;
+    out[7] = height >> 8;
+    out[8] = pixel_bytes;
+    out[9] = 0;
+    return RA8876_RLE_HEADER;
+}
+
+size_t ra8876_rle_encode(const uint8_t *pixels, size_t count, uint8_t pixel_bytes, uint8_t *out, size_t cap) {
+    size_t i = 0, o = 0;
+    uint8_t pb = pixel_bytes;
+    while (i < count) {
+        size_t run = 1;
+        while (i + run < count && run < 128 && memcmp(&pixels[(i + run) * pb], &pixels[i * pb], pb) == 0) run++;
+        if (run >= 3) {
+            if (o + 1 + pb > cap) return 0;
+            out[o++] = 0x80 | (run - 1);
+            memcpy(&out[o], &pixels[i * pb], pb);
+            o += pb;
+            i += run;
+            continue;
+        }
+        size_t lit = 0;
+        while (i + lit < count && lit < 128) {
+            const uint8_t *p = &pixels[(i + lit) * pb];
+            if (i + lit + 2 < count && memcmp(p, p + pb, pb) == 0 && memcmp(p, p + 2 * pb, pb) == 0) break;
+            lit++;
+        }
+        if (o + 1 + lit * pb > cap) return 0;
+        out[o++] = lit - 1;
+        memcpy(&out[o], &pixels[i * pb], lit * pb);
+        o += lit * pb;
+        i += lit;
+    }
+    return o;
+}
+
+typedef struct {
+    const uint8_t *blob;
+    size_t size;
+    size_t pos;
+    size_t left;
+    uint8_t pixel_bytes;
+    bool repeat;
+    bool ok;
+} rle_reader_t;
+
+static void rle_read(rle_reader_t *r, uint8_t *out, size_t n) {
+    uint8_t pb = r->pixel_bytes;
+    while (n > 0) {
+        if (r->left == 0) {
+            uint8_t ctrl = 0;
+            size_t count = 0;
+            if (r->ok && r->pos < r->size) {
+                ctrl = r->blob[r->pos++];
+                count = (ctrl & 0x7F) + 1;
+            }
+            if (count == 0 || r->pos + ((ctrl & 0x80) ? 1 : count) * pb > r->size) {
+                r->ok = false;
+                memset(out, 0, n * pb);
+                return;
+            }
+            r->left = count;
+            r->repeat = ctrl & 0x80;
+        }
+        size_t k = r->left < n ? r->left : n;
+        if (r->repeat) {
+            const uint8_t *px = &r->blob[r->pos];
+            if (pb == 1) {
+                memset(out, px[0], k);
+            } else {
+                for (size_t i = 0; i < k; i++)
+                    memcpy(&out[i * pb], px, pb);
+            }
+            if (k == r->left) r->pos += pb;
+        } else {
+            memcpy(out, &r->blob[r->pos], k * pb);
+            r->pos += k * pb;
+        }
+        r->left -= k;
+        out += k * pb;
+        n -= k;
+    }
+}
+
+bool ra8876_draw_rle(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, const uint8_t *blob, size_t size) {
+    ra8876_rle_info_t info;
+    if (!ra8876_rle_info(blob, size, &info) || info.pixel_bytes != ra8876_pixel_bytes(dev)) return false;
+
+    uint8_t chunk[RA8876_RLE_CHUNK];
+    rle_reader_t r = { blob, size, RA8876_RLE_HEADER, 0, info.pixel_bytes, false, true };
+    size_t remaining = (size_t)info.width * info.height;
+    size_t per_chunk = sizeof(chunk) / info.pixel_bytes;
+
+    ra8876_bte_write_begin(dev, addr, x, y, info.width, info.height);
+    while (remaining > 0) {
+        size_t n = remaining < per_chunk ? remaining : per_chunk;
+        rle_read(&r, chunk, n);
+        ra8876_bte_write_data(dev, chunk, n * info.pixel_bytes);
+        remaining -= n;
+    }
+    ra8876_bte_write_end(dev);
+    return r.ok;
+}
+
+#define RUN_FILL_COST 86
+#define RUN_SPAN_COST 82
+#define RUN_BYTES(n)  ((uint32_t)(n) * (RA8876_BURST_SIZE + 3) / RA8876_BURST_SIZE)
+
+static inline uint32_t pixel_at(const uint8_t *p, uint8_t pb) {
+    uint32_t v = p[0];
+    if (pb > 1) v |= p[1] << 8;
+    if (pb > 2) v |= (uint32_t)p[2] << 16;
+    return v;
+}
+
+static uint32_t pixel_color(uint32_t v, uint8_t pb) {
+    if (pb == 1) return ra8876_unpack_rgb332(v);
+    if (pb == 2) return ra8876_rgb((v >> 8) & 0xF8, (v >> 3) & 0xFC, (v << 3) & 0xF8);
+    return ra8876_rgb(v >> 16, (v >> 8) & 0xFF, v & 0xFF);
+}
+
+typedef struct {
+    uint16_t x;
+    uint16_t len;
+    uint16_t y0;
+    uint16_t h;
+    uint32_t color;
+    bool fill;
+} run_open_t;
+
+typedef struct {
+    ra8876_t *dev;
+    uint32_t addr;
+    uint16_t x;
+    uint16_t y;
+    const uint8_t *data;
+    uint16_t stride;
+    uint16_t height;
+    uint8_t pb;
+    run_open_t open[RA8876_RUN_OPEN_MAX];
+    uint8_t num_open;
+} run_ctx_t;
+
+static void run_emit(run_ctx_t *rc, const run_open_t *o, const uint8_t *row) {
+    if (o->fill) {
+        ra8876_bte_solid_fill(rc->dev, rc->addr, rc->x + o->x, rc->y + o->y0, o->len, o->h,
+                              pixel_color(o->color, rc->pb));
+        return;
+    }
+    ra8876_bte_write_begin(rc->dev, rc->addr, rc->x + o->x, rc->y + o->y0, o->len, o->h);
+    for (uint16_t r = 0; r < o->h; r++) {
+        const uint8_t *src = rc->data ? &rc->data[(size_t)(o->y0 + r) * rc->stride * rc->pb] : row;
+        ra8876_bte_write_data(rc->dev, &src[o->x * rc->pb], (size_t)o->len * rc->pb);
+    }
+    ra8876_bte_write_end(rc->dev);
+}
+
+static run_open_t *run_find(run_ctx_t *rc, bool fill, uint16_t x, uint16_t len, uint32_t color, uint16_t ry) {
+    for (uint8_t i = 0; i < rc->num_open; i++) {
+        run_open_t *o = &rc->open[i];
+        if (o->fill == fill && o->x == x && o->len == len && o->y0 + o->h == ry && (!fill || o->color == color))
+            return o;
+    }
+    return NULL;
 }
 
-void ra8876_bte_write(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
-                      uint16_t width, uint16_t height, const uint8_t *data) {
-    ra8876_wait_task_busy(dev);
-    bte_set_dest(dev, addr, dev->width, x, y);
-    bte_set_size(dev, width, height);
-    bte_start_mpu(dev, RA8876_ROP_S, 0x00);
-    while (ra8876_read_status(dev) & 0x80);
-    ra8876_write_data_burst(dev, data, (size_t)width * height );
-    bte_wait_mpu(dev);
+static void run_add(run_ctx_t *rc, bool fill, uint16_t x, uint16_t len, uint32_t color, uint16_t ry, const uint8_t *row) {
+    run_open_t *o = (fill || rc->data) ? run_find(rc, fill, x, len, color, ry) : NULL;
+    if (o) {
+        o->h++;
+        return;
+    }
+    run_open_t n = { x, len, ry, 1, color, fill };
+    if ((!fill && !rc->data) || rc->num_open == RA8876_RUN_OPEN_MAX) {
+        run_emit(rc, &n, row);
+        return;
+    }
+    rc->open[rc->num_open++] = n;
 }
 
-void ra8876_bte_write_chroma(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
-                             uint16_t width, uint16_t height,
-                             const uint8_t *data, uint32_t chroma) {
+static void run_flush(run_ctx_t *rc, uint16_t ry, bool all) {
+    uint8_t k = 0;
+    for (uint8_t i = 0; i < rc->num_open; i++) {
+        if (all || rc->open[i].y0 + rc->open[i].h != ry + 1)
+            run_emit(rc, &rc->open[i], NULL);
+        else
+            rc->open[k++] = rc->open[i];
+    }
+    rc->num_open = k;
+}
+
+static uint16_t run_extent(run_ctx_t *rc, uint16_t x, uint16_t len, uint32_t color, uint16_t ry) {
+    if (!rc->data) return 1;
+    uint16_t h = 1;
+    while (h < RA8876_RUN_LOOKAHEAD && ry + h < rc->height) {
+        const uint8_t *p = &rc->data[((size_t)(ry + h) * rc->stride + x) * rc->pb];
+        uint16_t k = 0;
+        while (k < len && pixel_at(&p[k * rc->pb], rc->pb) == color) k++;
+        if (k < len) break;
+        h++;
+    }
+    return h;
+}
+
+static void run_row(run_ctx_t *rc, const uint8_t *row, uint16_t width, uint16_t ry) {
+    uint8_t pb = rc->pb;
+    int32_t detail = -1;
+    uint16_t i = 0;
+    while (i < width) {
+        uint32_t color = pixel_at(&row[i * pb], pb);
+        uint16_t j = i + 1;
+        while (j < width && pixel_at(&row[j * pb], pb) == color) j++;
+        uint16_t len = j - i;
+        uint16_t cost = run_find(rc, true, i, len, color, ry) ? 0 : RUN_FILL_COST / run_extent(rc, i, len, color, ry);
+        if (detail >= 0 && j < width) cost += RUN_SPAN_COST;
+        if (RUN_BYTES(len * pb) > cost) {
+            if (detail >= 0) run_add(rc, false, detail, i - detail, 0, ry, row);
+            detail = -1;
+            run_add(rc, true, i, len, color, ry, row);
+        } else if (detail < 0) {
+            detail = i;
+        }
+        i = j;
+    }
+    if (detail >= 0) run_add(rc, false, detail, width - detail, 0, ry, row);
+    run_flush(rc, ry, false);
+}
+
+void ra8876_bte_write_runs(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                           uint16_t width, uint16_t height, const uint8_t *data) {
+    run_ctx_t rc = { dev, addr, x, y, data, width, height, ra8876_pixel_bytes(dev), {{0}}, 0 };
+    for (uint16_t ry = 0; ry < height; ry++)
+        run_row(&rc, &data[(size_t)ry * width * rc.pb], width, ry);
+    run_flush(&rc, height, true);
+}
+
+static uint32_t rle_runs_cost(const uint8_t *blob, size_t size, const ra8876_rle_info_t *info) {
+    size_t total = (size_t)info->width * info->height, done = 0, pos = RA8876_RLE_HEADER;
+    uint8_t pb = info->pixel_bytes;
+    uint32_t cost = 0;
+    uint16_t x = 0;
+    bool detail = false;
+    while (done < total && pos < size) {
+        uint8_t ctrl = blob[pos++];
+        size_t n = (ctrl & 0x7F) + 1;
+        bool repeat = ctrl & 0x80;
+        pos += (repeat ? 1 : n) * pb;
+        while (n > 0 && done < total) {
+            uint16_t seg = info->width - x;
+            if (n < seg) seg = n;
+            uint32_t bytes = RUN_BYTES(seg * pb);
+            if (repeat && bytes > RUN_FILL_COST + (detail ? RUN_SPAN_COST : 0)) {
+                cost += RUN_FILL_COST;
+                detail = false;
+            } else {
+                if (!detail) cost += RUN_SPAN_COST;
+                cost += bytes;
+                detail = true;
+            }
+            x += seg;
+            n -= seg;
+            done += seg;
+            if (x == info->width) {
+                x = 0;
+                detail = false;
+            }
+        }
+    }
+    return cost;
+}
+
+bool ra8876_draw_rle_runs(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, const uint8_t *blob, size_t size) {
+    ra8876_rle_info_t info;
+    if (!ra8876_rle_info(blob, size, &info) || info.pixel_bytes != ra8876_pixel_bytes(dev) ||
+        info.width > RA8876_RUN_ROW_MAX) return false;
+    uint32_t raw_cost = RUN_BYTES((uint32_t)info.width * info.height * info.pixel_bytes) + RUN_SPAN_COST;
+    if (rle_runs_cost(blob, size, &info) >= raw_cost)
+        return ra8876_draw_rle(dev, addr, x, y, blob, size);
+
+    uint8_t row[RA8876_RUN_ROW_MAX * 3];
+    rle_reader_t r = { blob, size, RA8876_RLE_HEADER, 0, info.pixel_bytes, false, true };
+    run_ctx_t rc = { dev, addr, x, y, NULL, info.width, info.height, info.pixel_bytes, {{0}}, 0 };
+    for (uint16_t ry = 0; ry < info.height; ry++) {
+        rle_read(&r, row, info.width);
+        run_row(&rc, row, info.width, ry);
+    }
+    run_flush(&rc, info.height, true);
+    return r.ok;
+}
+
+#if defined(__ARM_FEATURE_SIMD32)
+static inline uint32_t uqadd8(uint32_t a, uint32_t b) {
+    return __uqadd8(a, b);
+}
+#else
+static inline uint32_t uqadd8(uint32_t a, uint32_t b) {
+    uint32_t sum = (a & 0x7F7F7F7F) + (b & 0x7F7F7F7F);
+    uint32_t carry = (a & b) | ((a | b) & sum);
+    uint32_t over = (carry & 0x80808080) >> 7;
+    return (sum ^ ((a ^ b) & 0x80808080)) | (over * 0xFF);
+}
+#endif
+
+static const uint8_t bayer4[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+static inline uint32_t pack_planar332(uint32_t r, uint32_t g, uint32_t b) {
+    return (r & 0xE0E0E0E0) | ((g >> 3) & 0x1C1C1C1C) | ((b >> 6) & 0x03030303);
+}
+
+static void bayer_words(uint16_t x, uint16_t y, uint32_t *rg, uint32_t *b) {
+    *rg = 0;
+    *b = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t t = bayer4[y & 3][(x + i) & 3];
+        *rg |= (uint32_t)(t * 2 + 1) << (i * 8);
+        *b |= (uint32_t)(t * 4 + 2) << (i * 8);
+    }
+}
+
+static inline uint8_t fs_channel(int16_t v, uint8_t levels, int16_t *e) {
+    if (v < 0) v = 0;
+    if (v > 255) v = 255;
+    uint8_t l = (v * levels + 127) / 255;
+    *e = v - l * 255 / levels;
+    return l;
+}
+
+static void conv_fs(ra8876_conv_t *c, const uint8_t *rgb, uint8_t *dst, uint16_t x) {
+    static const uint8_t levels[2][3] = { { 7, 7, 3 }, { 31, 63, 31 } };
+    const uint8_t *lv = levels[c->out_bytes == 2];
+    int16_t *err = &c->err[x * 3];
+    int16_t e[3];
+    uint8_t l[3];
+    for (uint8_t k = 0; k < 3; k++) {
+        l[k] = fs_channel(rgb[k] + err[k] + c->carry[k], lv[k], &e[k]);
+        c->carry[k] = e[k] * 7 / 16;
+        if (x > 0) err[k - 3] += e[k] * 3 / 16;
+        err[k] = e[k] * 5 / 16 + c->pending[k];
+        c->pending[k] = e[k] / 16;
+    }
+    if (c->out_bytes == 2) {
+        uint16_t v = (l[0] << 11) | (l[1] << 5) | l[2];
+        dst[0] = v & 0xFF;
+        dst[1] = v >> 8;
+    } else {
+        dst[0] = (l[0] << 5) | (l[1] << 2) | l[2];
+    }
+}
+
+static void conv_span(ra8876_conv_t *c, const uint8_t *src, uint8_t *dst, uint16_t n, bool rgb565) {
+    uint16_t i = 0;
+    if (c->out_bytes == 1 && c->dither != RA8876_DITHER_FS) {
+        uint32_t trg = 0, tb = 0;
+        if (c->dither == RA8876_DITHER_BAYER) bayer_words(c->x, c->y, &trg, &tb);
+        for (; i + 4 <= n; i += 4) {
+            uint32_t r = 0, g = 0, b = 0;
+            for (uint8_t k = 0; k < 4; k++) {
+                uint8_t pr, pg, pb;
+                if (rgb565) {
+                    uint16_t p = src[(i + k) * 2] | (src[(i + k) * 2 + 1] << 8);
+                    pr = (p >> 8) & 0xF8;
+                    pg = (p >> 3) & 0xFC;
+                    pb = (p << 3) & 0xF8;
+                } else {
+                    pr = src[(i + k) * 3];
+                    pg = src[(i + k) * 3 + 1];
+                    pb = src[(i + k) * 3 + 2];
+                }
+                r |= (uint32_t)pr << (k * 8);
+                g |= (uint32_t)pg << (k * 8);
+                b |= (uint32_t)pb << (k * 8);
+            }
+            if (c->dither == RA8876_DITHER_BAYER) {
+                r = uqadd8(r - ((r >> 3) & 0x1F1F1F1F), trg);
+                g = uqadd8(g - ((g >> 3) & 0x1F1F1F1F), trg);
+                b = uqadd8(b - ((b >> 2) & 0x3F3F3F3F), tb);
+            }
+            uint32_t out = pack_planar332(r, g, b);
+            memcpy(&dst[i], &out, 4);
+        }
+    }
+    for (; i < n; i++) {
+        uint8_t *o = &dst[i * c->out_bytes];
+        uint8_t rgb[3];
+        if (rgb565) {
+            if (c->out_bytes == 2) {
+                o[0] = src[i * 2];
+                o[1] = src[i * 2 + 1];
+                continue;
+            }
+            uint16_t p = src[i * 2] | (src[i * 2 + 1] << 8);
+            rgb[0] = (p >> 8) & 0xF8;
+            rgb[1] = (p >> 3) & 0xFC;
+            rgb[2] = (p << 3) & 0xF8;
+        } else {
+            memcpy(rgb, &src[i * 3], 3);
+        }
+        if (c->out_bytes == 3) {
+            o[0] = rgb[2];
+            o[1] = rgb[1];
+            o[2] = rgb[0];
+            continue;
+        }
+        uint16_t px = c->x + i;
+        if (c->dither == RA8876_DITHER_FS) {
+            conv_fs(c, rgb, o, px);
+            continue;
+        }
+        if (c->dither == RA8876_DITHER_BAYER) {
+            uint8_t t = bayer4[c->y & 3][px & 3];
+            if (c->out_bytes == 2) {
+                rgb[0] = rgb[0] - (rgb[0] >> 5) + (t >> 1);
+                rgb[1] = rgb[1] - (rgb[1] >> 6) + (t >> 2);
+                rgb[2] = rgb[2] - (rgb[2] >> 5) + (t >> 1);
+            } else {
+                rgb[0] = rgb[0] - (rgb[0] >> 3) + t * 2 + 1;
+                rgb[1] = rgb[1] - (rgb[1] >> 3) + t * 2 + 1;
+                rgb[2] = rgb[2] - (rgb[2] >> 2) + t * 4 + 2;
+            }
+        }
+        if (c->out_bytes == 2) {
+            uint16_t v = ra8876_pack_rgb565(rgb[0], rgb[1], rgb[2]);
+            o[0] = v & 0xFF;
+            o[1] = v >> 8;
+        } else {
+            o[0] = ra8876_pack_rgb332(rgb[0], rgb[1], rgb[2]);
+        }
+    }
+}
+
+static void conv_pixels(ra8876_conv_t *c, const uint8_t *src, uint8_t *dst, size_t count, bool rgb565) {
+    uint8_t in_bytes = rgb565 ? 2 : 3;
+    while (count > 0) {
+        if (c->x == 0) {
+            memset(c->carry, 0, sizeof(c->carry));
+            memset(c->pending, 0, sizeof(c->pending));
+        }
+        uint16_t n = c->width - c->x;
+        if (n > count) n = count;
+        conv_span(c, src, dst, n, rgb565);
+        src += (size_t)n * in_bytes;
+        dst += (size_t)n * c->out_bytes;
+        count -= n;
+        c->x += n;
+        if (c->x == c->width) {
+            c->x = 0;
+            c->y++;
+        }
+    }
+}
+
+void ra8876_conv_init(ra8876_conv_t *c, uint16_t width, uint8_t bpp, uint8_t dither, int16_t *err) {
+    c->width = width;
+    c->out_bytes = bpp / 8;
+    c->dither = (dither == RA8876_DITHER_FS && !err) ? RA8876_DITHER_BAYER : dither;
+    c->err = err;
+    c->x = 0;
+    c->y = 0;
+    if (c->dither == RA8876_DITHER_FS) memset(err, 0, (size_t)width * 3 * sizeof(int16_t));
+}
+
+void ra8876_conv_rgb888(ra8876_conv_t *c, const uint8_t *src, uint8_t *dst, size_t count) {
+    conv_pixels(c, src, dst, count, false);
+}
+
+void ra8876_conv_rgb565(ra8876_conv_t *c, const uint16_t *src, uint8_t *dst, size_t count) {
+    conv_pixels(c, (const uint8_t *)src, dst, count, true);
+}
+
+static void bte_write_conv(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                           const uint8_t *data, bool rgb565, uint8_t dither, int16_t *err) {
+    ra8876_conv_t c;
+    uint8_t chunk[RA8876_CONV_CHUNK];
+    size_t remaining = (size_t)width * height;
+    uint8_t in_bytes = rgb565 ? 2 : 3;
+
+    ra8876_conv_init(&c, width, dev->bpp, dither, err);
+    size_t per_chunk = sizeof(chunk) / c.out_bytes;
+    ra8876_bte_write_begin(dev, addr, x, y, width, height);
+    while (remaining > 0) {
+        size_t n = remaining < per_chunk ? remaining : per_chunk;
+        conv_pixels(&c, data, chunk, n, rgb565);
+        ra8876_bte_write_data(dev, chunk, n * c.out_bytes);
+        data += n * in_bytes;
+        remaining -= n;
+    }
+    ra8876_bte_write_end(dev);
+}
+
+void ra8876_bte_write_rgb888(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                             const uint8_t *data, uint8_t dither, int16_t *err) {
+    bte_write_conv(dev, addr, x, y, width, height, data, false, dither, err);
+}
+
+void ra8876_bte_write_rgb565(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                             const uint16_t *data, uint8_t dither, int16_t *err) {
+    bte_write_conv(dev, addr, x, y, width, height, (const uint8_t *)data, true, dither, err);
+}
+
+static uint32_t depth_quant(uint8_t bpp, uint32_t color, uint8_t threshold) {
+    static const uint8_t bits[3][3] = { { 2, 3, 3 }, { 5, 6, 5 }, { 8, 8, 8 } };
+    const uint8_t *b = bits[depth_code(bpp)];
+    uint32_t out = 0;
+    for (int i = 0; i < 3; i++) {
+        uint32_t levels = (1u << b[i]) - 1;
+        uint32_t v = ((color >> (i * 8)) & 0xFF) * levels * 32 + threshold * 255;
+        out |= (v / (255 * 32)) << (8 - b[i]) << (i * 8);
+    }
+    return out;
+}
+
+static uint32_t depth_round(uint8_t bpp, uint32_t color) {
+    return depth_quant(bpp, color, 16);
+}
+
+static uint32_t gradient_color(uint32_t c0, uint32_t c1, int32_t p, int32_t span) {
+    if (span <= 0) return c0;
+    uint32_t out = 0;
+    for (int sh = 0; sh < 24; sh += 8) {
+        int32_t a = (c0 >> sh) & 0xFF, b = (c1 >> sh) & 0xFF;
+        out |= (uint32_t)(a + (b - a) * p / span) << sh;
+    }
+    return out;
+}
+
+typedef struct {
+    uint32_t c0, c1;
+    int32_t from, span;
+    uint8_t bpp;
+} gradient_t;
+
+static uint32_t gradient_at(const gradient_t *g, int32_t p) {
+    return depth_round(g->bpp, gradient_color(g->c0, g->c1, g->from + p, g->span - 1));
+}
+
+static int32_t gradient_run(const gradient_t *g, int32_t p, int32_t n, uint32_t *q) {
+    *q = gradient_at(g, p);
+    while (++p < n && gradient_at(g, p) == *q);
+    return p;
+}
+
+static void gradient_band(int32_t x, int32_t y, int32_t w, int32_t h, bool vertical,
+                          int32_t s, int32_t e, ra8876_rect_t *r) {
+    r->x = vertical ? x : x + s;
+    r->y = vertical ? y + s : y;
+    r->w = vertical ? w : e - s;
+    r->h = vertical ? e - s : h;
+}
+
+static void gradient_dither(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, bool vertical,
+                            const gradient_t *g, int32_t n, ra8876_pattern_cache_t *cache) {
+    uint8_t pixels[8 * 8 * 3];
+    ra8876_rect_t r;
+    for (int32_t s = 0, e; s < n; s = e) {
+        uint32_t q;
+        e = gradient_run(g, s, n, &q);
+        int32_t len = e - s;
+        if (len < RA8876_GRADIENT_DITHER_MIN) continue;
+        int32_t m = len / 4 < 8 ? len / 4 : 8;
+        for (int32_t j = 0; j < m; j++) {
+            int32_t a = s + len * j / m, b = s + len * (j + 1) / m;
+            uint32_t ideal = gradient_color(g->c0, g->c1, g->from * 2 + a + b - 1, g->span * 2 - 2);
+            uint8_t *out = pixels;
+            bool flat = true;
+            for (int row = 0; row < 8; row++)
+                for (int col = 0; col < 8; col++) {
+                    uint32_t c = depth_quant(g->bpp, ideal, bayer4[row & 3][col & 3] * 2 + 1);
+                    if (c != q) flat = false;
+                    out += ra8876_put_pixel(dev, out, c);
+                }
+            if (flat) continue;
+            int8_t handle = ra8876_pattern_add(dev, cache, pixels, 8);
+            if (handle == RA8876_PATTERN_NONE) return;
+            gradient_band(x, y, w, h, vertical, a, b, &r);
+            ra8876_pattern_fill(dev, cache, handle, dev->canvas_addr, r.x, r.y, r.w, r.h, RA8876_ROP_S);
+            ra8876_pattern_remove(cache, handle);
+        }
+    }
+}
+
+static void gradient_axis(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, bool vertical,
+                          const gradient_t *g, ra8876_pattern_cache_t *dither) {
+    int32_t n = vertical ? h : w;
+    if (w <= 0 || h <= 0 || !ra8876_clip_visible(dev, x, y, w, h)) return;
+    if (!ra8876_clip_push(dev, x, y, w, h)) return;
+
+    ra8876_rect_t c = dev->clip;
+    int32_t lo = vertical ? c.y - y : c.x - x, hi = lo + (vertical ? c.h : c.w);
+    int32_t band = 0;
+    for (int32_t s = lo, e; s < hi; s = e) {
+        uint32_t q;
+        e = gradient_run(g, s, hi, &q);
+        if (e - s > band) band = e - s;
+    }
+
+    touch(dev, dev->canvas_addr, c.x, c.y, c.w, c.h);
     ra8876_wait_task_busy(dev);
-    set_bg_draw_color(dev, chroma);
-    bte_set_dest(dev, addr, dev->width, x, y);
-    bte_set_size(dev, width, height);
-    bte_start_mpu(dev, RA8876_ROP_S, 0x04);
-    while (ra8876_read_status(dev) & 0x80);
-    ra8876_write_data_burst(dev, data, (size_t)width * height );
-    bte_wait_mpu(dev);
+    ra8876_bte_batch_start(dev, dev->canvas_addr, vertical ? c.w : band, vertical ? band : c.h);
+    for (int32_t s = lo, e; s < hi; s = e) {
+        uint32_t q;
+        e = gradient_run(g, s, hi, &q);
+        ra8876_bte_batch_fill(dev, vertical ? c.x : x + s, vertical ? y + s : c.y, q);
+    }
+    if (dither) gradient_dither(dev, x, y, w, h, vertical, g, n, dither);
+    ra8876_clip_pop(dev);
 }
 
-void ra8876_bte_expand(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
-                       uint16_t width, uint16_t height,
-                       const uint8_t *bitmap, uint32_t fg, uint32_t bg) {
+void ra8876_gradient_rect(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h,
+                          uint32_t c0, uint32_t c1, bool vertical, ra8876_pattern_cache_t *dither) {
+    gradient_t g = { c0, c1, 0, vertical ? h : w, dev->bpp };
+    gradient_axis(dev, x, y, w, h, vertical, &g, dither);
+}
+
+void ra8876_gradient_rounded_rect(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r,
+                                  uint32_t c0, uint32_t c1, bool vertical, ra8876_pattern_cache_t *dither) {
+    if (r > w / 2) r = w / 2;
+    if (r > h / 2) r = h / 2;
+    if (r < 0) r = 0;
+    int32_t n = vertical ? h : w;
+    gradient_t g = { c0, c1, r, n, dev->bpp };
+    if (vertical)
+        gradient_axis(dev, x, y + r, w, h - 2 * r, true, &g, dither);
+    else
+        gradient_axis(dev, x + r, y, w - 2 * r, h, false, &g, dither);
+
+    g.from = 0;
+    ra8876_rect_t band, strip;
+    for (int32_t s = 0, e; s < n; s = e) {
+        uint32_t q;
+        e = gradient_run(&g, s, n, &q);
+        if (s < r && e > r) e = r;
+        if (s < n - r && e > n - r) e = n - r;
+        if (s >= r && s < n - r) continue;
+        gradient_band(x, y, w, h, vertical, s, e, &band);
+        if (!ra8876_clip_visible(dev, band.x, band.y, band.w, band.h)) continue;
+        gradient_band(x, y, w, h, vertical, s < r ? 0 : n - 2 * r, s < r ? 2 * r : n, &strip);
+        if (!ra8876_clip_push(dev, band.x, band.y, band.w, band.h)) return;
+        ra8876_fill_rounded_rect_s(dev, strip.x, strip.y, strip.w, strip.h, r, q);
+        ra8876_clip_pop(dev);
+    }
+}
+
+void ra8876_gradient_radial(ra8876_t *dev, int32_t x, int32_t y, int32_t rx, int32_t ry,
+                            uint32_t inner, uint32_t outer) {
+    int32_t n = rx > ry ? rx : ry;
+    if (n <= 0) return;
+    gradient_t g = { inner, outer, 0, n + 1, dev->bpp };
+    for (int32_t e = n + 1, s; e > 0; e = s) {
+        uint32_t q = gradient_at(&g, e - 1);
+        for (s = e - 1; s > 0 && gradient_at(&g, s - 1) == q; s--);
+        int32_t ex = rx * (e - 1) / n, ey = ry * (e - 1) / n;
+        ra8876_fill_ellipse_s(dev, x, y, ex > 0 ? ex : 1, ey > 0 ? ey : 1, q);
+    }
+}
+
+enum {
+    AA_SEGMENT,
+    AA_RING,
+    AA_ARC,
+};
+
+typedef struct {
+    uint8_t kind;
+    float ax, ay;
+    float bx, by;
+    float r;
+    float hw;
+    float a0, sweep;
+    float e0x, e0y, e1x, e1y;
+} aa_shape_t;
+
+static uint8_t aa_scratch_level[2][RA8876_AA_CHUNK * RA8876_AA_CHUNK];
+static uint8_t aa_scratch_bits[2][RA8876_AA_CHUNK * RA8876_AA_CHUNK / 8];
+
+static float aa_dist(const aa_shape_t *s, float px, float py) {
+    float dx = px - s->ax, dy = py - s->ay;
+    switch (s->kind) {
+        case AA_SEGMENT: {
+            float sx = s->bx - s->ax, sy = s->by - s->ay;
+            float len2 = sx * sx + sy * sy;
+            float t = len2 > 0 ? (dx * sx + dy * sy) / len2 : 0;
+            if (t < 0) t = 0;
+            else if (t > 1) t = 1;
+            return hypotf(dx - t * sx, dy - t * sy);
+        }
+        case AA_RING:
+            return fabsf(hypotf(dx, dy) - s->r);
+        default: {
+            float a = atan2f(dy, dx) - s->a0;
+            a -= floorf(a / (2 * (float)M_PI)) * 2 * (float)M_PI;
+            if (a <= s->sweep) return fabsf(hypotf(dx, dy) - s->r);
+            float d0 = hypotf(px - s->e0x, py - s->e0y);
+            float d1 = hypotf(px - s->e1x, py - s->e1y);
+            return d0 < d1 ? d0 : d1;
+        }
+    }
+}
+
+static void bte_rop(ra8876_t *dev, uint32_t s0_addr, uint16_t s0_x, uint16_t s0_y,
+                    uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
+                    uint16_t width, uint16_t height, uint8_t rop) {
     ra8876_wait_task_busy(dev);
-    set_draw_color(dev, fg);
-    set_bg_draw_color(dev, bg);
-    bte_set_dest(dev, addr, dev->width, x, y);
+    bte_set_source0(dev, s0_addr, dev->width, s0_x, s0_y);
+    bte_set_source1(dev, dst_addr, dev->width, dst_x, dst_y);
+    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
     bte_set_size(dev, width, height);
-    bte_start_mpu(dev, RA8876_ROP_S, 0x08);
-    size_t row_bytes = (width + 7) / 8;
-    while (ra8876_read_status(dev) & 0x80);
-    ra8876_write_data_burst(dev, bitmap, row_bytes * height);
-    bte_wait_mpu(dev);
+    bte_start(dev, rop, 0x02);
 }
 
-void ra8876_bte_expand_chroma(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
-                              uint16_t width, uint16_t height,
-                              const uint8_t *bitmap, uint32_t fg) {
+static void aa_blend_level(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                           const uint8_t *bits, uint32_t color, uint8_t alpha) {
+    uint32_t a = dev->aa_addr;
+    uint32_t canvas = dev->canvas_addr;
+    ra8876_bte_expand(dev, a, RA8876_AA_CHUNK, 0, w, h, bits, RA8876_WHITE, RA8876_BLACK);
+    ra8876_bte_solid_fill(dev, a, 0, 0, w, h, color);
+    ra8876_bte_blend(dev, a, 0, 0, canvas, x, y, a, 0, 0, w, h, alpha);
+    bte_rop(dev, a, RA8876_AA_CHUNK, 0, a, 0, 0, w, h, RA8876_ROP_S_AND_D);
+    bte_rop(dev, a, RA8876_AA_CHUNK, 0, canvas, x, y, w, h, RA8876_ROP_NOT_S_AND_D);
+    bte_rop(dev, a, 0, 0, canvas, x, y, w, h, RA8876_ROP_S_OR_D);
+}
+
+static void aa_chunk(ra8876_t *dev, const aa_shape_t *s, uint32_t color,
+                     uint16_t cx, uint16_t cy, uint16_t cw, uint16_t ch) {
+    uint16_t x0[RA8876_AA_LEVELS + 1], y0[RA8876_AA_LEVELS + 1];
+    uint16_t x1[RA8876_AA_LEVELS + 1], y1[RA8876_AA_LEVELS + 1];
+    uint16_t count[RA8876_AA_LEVELS + 1] = {0};
+    bool blend = dev->aa_addr != RA8876_SDRAM_NONE;
+    uint8_t core = get_core_num();
+    uint8_t *aa_level = aa_scratch_level[core];
+    uint8_t *aa_bits = aa_scratch_bits[core];
+
+    for (uint16_t j = 0; j < ch; j++) {
+        for (uint16_t i = 0; i < cw; i++) {
+            float c = s->hw + 0.5f - aa_dist(s, cx + i, cy + j);
+            int level = c <= 0 ? 0 : c >= 1 ? RA8876_AA_LEVELS : (int)(c * RA8876_AA_LEVELS + 0.5f);
+            if (!blend) level = level * 2 >= RA8876_AA_LEVELS ? RA8876_AA_LEVELS : 0;
+            aa_level[j * RA8876_AA_CHUNK + i] = level;
+            if (level == 0) continue;
+            if (count[level]++ == 0) {
+                x0[level] = x1[level] = i;
+                y0[level] = y1[level] = j;
+                continue;
+            }
+            if (i < x0[level]) x0[level] = i;
+            if (i > x1[level]) x1[level] = i;
+            y1[level] = j;
+        }
+    }
+
+    for (int level = 1; level <= RA8876_AA_LEVELS; level++) {
+        if (count[level] == 0) continue;
+        uint16_t w = x1[level] - x0[level] + 1;
+        uint16_t h = y1[level] - y0[level] + 1;
+        if (level == RA8876_AA_LEVELS && count[level] == w * h) {
+            ra8876_bte_solid_fill(dev, dev->canvas_addr, cx + x0[level], cy + y0[level], w, h, color);
+            continue;
+        }
+
+        uint16_t row_bytes = (w + 7) / 8;
+        memset(aa_bits, 0, (size_t)row_bytes * h);
+        for (uint16_t j = 0; j < h; j++) {
+            const uint8_t *src = &aa_level[(y0[level] + j) * RA8876_AA_CHUNK + x0[level]];
+            uint8_t *dst = &aa_bits[j * row_bytes];
+            for (uint16_t i = 0; i < w; i++)
+                if (src[i] == level) dst[i >> 3] |= 0x80 >> (i & 7);
+        }
+
+        if (level == RA8876_AA_LEVELS)
+            ra8876_bte_expand_chroma(dev, dev->canvas_addr, cx + x0[level], cy + y0[level], w, h, aa_bits, color);
+        else
+            aa_blend_level(dev, cx + x0[level], cy + y0[level], w, h, aa_bits, color, level * 256 / RA8876_AA_LEVELS);
+    }
+}
+
+static void aa_draw(ra8876_t *dev, const aa_shape_t *s, float left, float top, float right, float bottom,
+                    uint32_t color) {
+    float pad = s->hw + 1;
+    int32_t bx0 = (int32_t)floorf(left - pad), by0 = (int32_t)floorf(top - pad);
+    int32_t bx1 = (int32_t)ceilf(right + pad), by1 = (int32_t)ceilf(bottom + pad);
+    const ra8876_rect_t *c = &dev->clip;
+    if (bx0 < c->x) bx0 = c->x;
+    if (by0 < c->y) by0 = c->y;
+    if (bx1 > c->x + c->w - 1) bx1 = c->x + c->w - 1;
+    if (by1 > c->y + c->h - 1) by1 = c->y + c->h - 1;
+    if (bx0 > bx1 || by0 > by1) return;
+
+    if (dev->aa_addr == RA8876_SDRAM_NONE) dev->aa_addr = ra8876_sdram_alloc(dev, RA8876_AA_CHUNK);
+
+    float reach = RA8876_AA_CHUNK * 0.7072f + pad;
+    for (int32_t cy = by0; cy <= by1; cy += RA8876_AA_CHUNK) {
+        uint16_t ch = by1 - cy + 1 < RA8876_AA_CHUNK ? by1 - cy + 1 : RA8876_AA_CHUNK;
+        for (int32_t cx = bx0; cx <= bx1; cx += RA8876_AA_CHUNK) {
+            uint16_t cw = bx1 - cx + 1 < RA8876_AA_CHUNK ? bx1 - cx + 1 : RA8876_AA_CHUNK;
+            if (aa_dist(s, cx + cw * 0.5f, cy + ch * 0.5f) > reach) continue;
+            aa_chunk(dev, s, color, cx, cy, cw, ch);
+        }
+    }
+}
+
+void ra8876_draw_line_aa(ra8876_t *dev, float x0, float y0, float x1, float y1, float width, uint32_t color) {
+    bool integral = x0 == floorf(x0) && y0 == floorf(y0) && x1 == floorf(x1) && y1 == floorf(y1) &&
+                    width == floorf(width) && width >= 1;
+    if (integral && (x0 == x1 || y0 == y1)) {
+        int32_t ax = x0 < x1 ? x0 : x1, ay = y0 < y1 ? y0 : y1;
+        int32_t bx = x0 < x1 ? x1 : x0, by = y0 < y1 ? y1 : y0;
+        int32_t lo = (int32_t)(width - 1) / 2, hi = (int32_t)width - 1 - lo;
+        if (x0 == x1) {
+            ax -= lo;
+            bx += hi;
+        } else {
+            ay -= lo;
+            by += hi;
+        }
+        if (ax < 0) ax = 0;
+        if (ay < 0) ay = 0;
+        if (bx > dev->width - 1) bx = dev->width - 1;
+        if (by > dev->height - 1) by = dev->height - 1;
+        if (ax > bx || ay > by) return;
+        if (width == 1)
+            ra8876_draw_line(dev, ax, ay, bx, by, color);
+        else
+            ra8876_fill_rect(dev, ax, ay, bx - ax + 1, by - ay + 1, color);
+        return;
+    }
+
+    aa_shape_t s = { .kind = AA_SEGMENT, .ax = x0, .ay = y0, .bx = x1, .by = y1, .hw = width * 0.5f };
+    aa_draw(dev, &s, fminf(x0, x1), fminf(y0, y1), fmaxf(x0, x1), fmaxf(y0, y1), color);
+}
+
+void ra8876_draw_circle_aa(ra8876_t *dev, float x, float y, float r, float width, uint32_t color) {
+    aa_shape_t s = { .kind = AA_RING, .ax = x, .ay = y, .r = r, .hw = width * 0.5f };
+    aa_draw(dev, &s, x - r, y - r, x + r, y + r, color);
+}
+
+void ra8876_draw_arc_aa(ra8876_t *dev, float x, float y, float r, float start_deg, float end_deg,
+                        float width, uint32_t color) {
+    float a0 = start_deg * (float)M_PI / 180;
+    float sweep = (end_deg - start_deg) * (float)M_PI / 180;
+    if (sweep < 0) {
+        sweep = -sweep;
+        a0 = end_deg * (float)M_PI / 180;
+    }
+    if (sweep >= 2 * (float)M_PI) {
+        ra8876_draw_circle_aa(dev, x, y, r, width, color);
+        return;
+    }
+    aa_shape_t s = {
+        .kind = AA_ARC, .ax = x, .ay = y, .r = r, .hw = width * 0.5f, .a0 = a0, .sweep = sweep,
+        .e0x = x + r * cosf(a0), .e0y = y + r * sinf(a0),
+        .e1x = x + r * cosf(a0 + sweep), .e1y = y + r * sinf(a0 + sweep),
+    };
+    aa_draw(dev, &s, x - r, y - r, x + r, y + r, color);
+}
+
+enum {
+    TRANS_IDLE,
+    TRANS_COMPOSE,
+    TRANS_WAIT,
+};
+
+static uint16_t trans_extent(ra8876_t *dev, uint8_t dir) {
+    return dir == RA8876_TRANS_LEFT || dir == RA8876_TRANS_RIGHT ? dev->width : dev->height;
+}
+
+static void trans_place(ra8876_t *dev, uint8_t src_page, int32_t dx, int32_t dy, uint32_t dst,
+                        int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t band0, int32_t band1) {
+    if (y0 < band0) y0 = band0;
+    if (y1 > band1) y1 = band1;
+    if (x0 >= x1 || y0 >= y1) return;
+    ra8876_bte_copy(dev, ra8876_page_addr(dev, src_page), x0 - dx, y0 - dy,
+                    dst, x0, y0, x1 - x0, y1 - y0, RA8876_ROP_S);
+}
+
+static void trans_unit(ra8876_t *dev, ra8876_transition_t *t, uint16_t u) {
+    uint32_t dst = ra8876_page_addr(dev, t->work_page[t->back]);
+    int32_t w = dev->width, h = dev->height;
+    int32_t b0 = u * RA8876_TRANS_BAND, b1 = b0 + RA8876_TRANS_BAND;
+    int32_t o = t->target, s = t->shown[t->back];
+
+    switch (t->kind) {
+        case RA8876_TRANS_CROSSFADE:
+            if (b1 > h) b1 = h;
+            ra8876_bte_blend(dev, ra8876_page_addr(dev, t->to_page), 0, b0,
+                             ra8876_page_addr(dev, t->from_page), 0, b0,
+                             dst, 0, b0, w, b1 - b0, t->progress > 255 ? 255 : t->progress);
+            break;
+        case RA8876_TRANS_WIPE:
+            switch (t->dir) {
+                case RA8876_TRANS_RIGHT: trans_place(dev, t->to_page, 0, 0, dst, s, 0, o, h, b0, b1); break;
+                case RA8876_TRANS_LEFT:  trans_place(dev, t->to_page, 0, 0, dst, w - o, 0, w - s, h, b0, b1); break;
+                case RA8876_TRANS_DOWN:  trans_place(dev, t->to_page, 0, 0, dst, 0, s, w, o, b0, b1); break;
+                default:                 trans_place(dev, t->to_page, 0, 0, dst, 0, h - o, w, h - s, b0, b1); break;
+            }
+            break;
+        case RA8876_TRANS_SLIDE:
+            switch (t->dir) {
+                case RA8876_TRANS_RIGHT:
+                    trans_place(dev, t->from_page, o, 0, dst, o, 0, w, h, b0, b1);
+                    trans_place(dev, t->to_page, o - w, 0, dst, 0, 0, o, h, b0, b1);
+                    break;
+                case RA8876_TRANS_LEFT:
+                    trans_place(dev, t->from_page, -o, 0, dst, 0, 0, w - o, h, b0, b1);
+                    trans_place(dev, t->to_page, w - o, 0, dst, w - o, 0, w, h, b0, b1);
+                    break;
+                case RA8876_TRANS_DOWN:
+                    trans_place(dev, t->from_page, 0, o, dst, 0, o, w, h, b0, b1);
+                    trans_place(dev, t->to_page, 0, o - h, dst, 0, 0, w, o, b0, b1);
+                    break;
+                default:
+                    trans_place(dev, t->from_page, 0, -o, dst, 0, 0, w, h - o, b0, b1);
+                    trans_place(dev, t->to_page, 0, h - o, dst, 0, h - o, w, h, b0, b1);
+                    break;
+            }
+            break;
+        default: {
+            uint16_t cols = (w + RA8876_TRANS_BLOCK - 1) / RA8876_TRANS_BLOCK;
+            uint16_t k = (uint32_t)(s + u) * t->step % t->blocks;
+            int32_t x = (k % cols) * RA8876_TRANS_BLOCK, y = (k / cols) * RA8876_TRANS_BLOCK;
+            int32_t x1 = x + RA8876_TRANS_BLOCK < w ? x + RA8876_TRANS_BLOCK : w;
+            int32_t y1 = y + RA8876_TRANS_BLOCK < h ? y + RA8876_TRANS_BLOCK : h;
+            trans_place(dev, t->to_page, 0, 0, dst, x, y, x1, y1, y, y1);
+            break;
+        }
+    }
+}
+
+static void trans_begin_frame(ra8876_t *dev, ra8876_transition_t *t) {
+    uint32_t elapsed = time_us_32() - t->start_us;
+    t->progress = elapsed >= t->duration_us ? 256 : (uint16_t)((uint64_t)elapsed * 256 / t->duration_us);
+    t->unit = 0;
+    t->state = TRANS_COMPOSE;
+    if (t->progress == 256) {
+        t->units = 0;
+        return;
+    }
+
+    uint16_t bands = (dev->height + RA8876_TRANS_BAND - 1) / RA8876_TRANS_BAND;
+    switch (t->kind) {
+        case RA8876_TRANS_WIPE:
+        case RA8876_TRANS_SLIDE:
+            t->target = (uint32_t)trans_extent(dev, t->dir) * t->progress / 256;
+            t->units = t->kind == RA8876_TRANS_WIPE && t->target <= t->shown[t->back] ? 0 : bands;
+            break;
+        case RA8876_TRANS_DISSOLVE:
+            t->target = (uint32_t)t->blocks * t->progress / 256;
+            t->units = t->target > t->shown[t->back] ? t->target - t->shown[t->back] : 0;
+            break;
+        default:
+            t->units = bands;
+            break;
+    }
+}
+
+static bool vsync_seen(ra8876_t *dev) {
+    if ((ra8876_read_reg(dev, RA8876_INTF) & 0x10) == 0) return false;
+    reg_wr(dev, RA8876_INTF, 0x10);
+    return true;
+}
+
+static uint16_t gcd16(uint16_t a, uint16_t b) {
+    while (b) {
+        uint16_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+bool ra8876_transition_start(ra8876_t *dev, ra8876_transition_t *t, uint8_t kind, uint8_t dir,
+                             uint8_t from_page, uint8_t to_page, uint8_t work0, uint8_t work1,
+                             uint16_t duration_ms) {
+    if (from_page >= dev->max_pages || to_page >= dev->max_pages ||
+        work0 >= dev->max_pages || work1 >= dev->max_pages || work0 == work1 ||
+        work0 == from_page || work0 == to_page || work1 == from_page || work1 == to_page)
+        return false;
+
+    t->kind = kind;
+    t->dir = dir;
+    t->from_page = from_page;
+    t->to_page = to_page;
+    t->work_page[0] = work0;
+    t->work_page[1] = work1;
+    t->back = 0;
+    t->shown[0] = 0;
+    t->shown[1] = 0;
+    t->frames = 0;
+    t->budget_us = 4000;
+    t->duration_us = duration_ms ? (uint32_t)duration_ms * 1000 : 1;
+
+    uint16_t cols = (dev->width + RA8876_TRANS_BLOCK - 1) / RA8876_TRANS_BLOCK;
+    uint16_t rows = (dev->height + RA8876_TRANS_BLOCK - 1) / RA8876_TRANS_BLOCK;
+    t->blocks = cols * rows;
+    t->step = t->blocks * 5 / 8 + 1;
+    while (gcd16(t->step, t->blocks) != 1) t->step++;
+
+    if (kind == RA8876_TRANS_WIPE || kind == RA8876_TRANS_DISSOLVE) {
+        ra8876_rect_t clip;
+        clip_suspend(dev, &clip);
+        for (int i = 0; i < 2; i++)
+            ra8876_bte_copy(dev, ra8876_page_addr(dev, from_page), 0, 0,
+                            ra8876_page_addr(dev, t->work_page[i]), 0, 0, dev->width, dev->height, RA8876_ROP_S);
+        clip_resume(dev, &clip);
+    }
+
+    t->start_us = time_us_32();
+    trans_begin_frame(dev, t);
+    return true;
+}
+
+void ra8876_transition_set_budget(ra8876_transition_t *t, uint32_t budget_us) {
+    t->budget_us = budget_us;
+}
+
+bool ra8876_transition_step(ra8876_t *dev, ra8876_transition_t *t) {
+    if (t->state == TRANS_IDLE) return false;
+
+    uint32_t t0 = time_us_32();
+    while (t->state == TRANS_COMPOSE && time_us_32() - t0 < t->budget_us) {
+        if (t->unit < t->units) {
+            ra8876_rect_t clip;
+            clip_suspend(dev, &clip);
+            trans_unit(dev, t, t->unit++);
+            clip_resume(dev, &clip);
+            continue;
+        }
+        if (t->kind == RA8876_TRANS_WIPE || t->kind == RA8876_TRANS_DISSOLVE)
+            t->shown[t->back] = t->target;
+        reg_wr(dev, RA8876_INTF, 0x10);
+        t->state = TRANS_WAIT;
+    }
+    if (t->state != TRANS_WAIT || !vsync_seen(dev)) return true;
+
     ra8876_wait_task_busy(dev);
-    set_draw_color(dev, fg);
-    bte_set_dest(dev, addr, dev->width, x, y);
-    bte_set_size(dev, width, height);
-    bte_start_mpu(dev, RA8876_ROP_S, 0x09);
-    size_t row_bytes = (width + 7) / 8;
-    while (ra8876_read_status(dev) & 0x80);
-    ra8876_write_data_burst(dev, bitmap, row_bytes * height);
-    bte_wait_mpu(dev);
+    t->frames++;
+    if (t->progress == 256) {
+        dev->display_page = t->to_page;
+        ra8876_set_display_addr(dev, ra8876_page_addr(dev, t->to_page));
+        t->state = TRANS_IDLE;
+        return false;
+    }
+    ra8876_set_display_addr(dev, ra8876_page_addr(dev, t->work_page[t->back]));
+    t->back ^= 1;
+    trans_begin_frame(dev, t);
+    return true;
+}
+
+void ra8876_transition_run(ra8876_t *dev, ra8876_transition_t *t) {
+    while (ra8876_transition_step(dev, t))
+        tight_loop_contents();
+}
+
+bool ra8876_backing_init(ra8876_t *dev, ra8876_backing_t *b, uint16_t rows) {
+    b->pool_addr = ra8876_sdram_alloc(dev, rows);
+    if (b->pool_addr == RA8876_SDRAM_NONE) return false;
+    b->pool_rows = rows;
+    b->depth = 0;
+    b->restored = 0;
+    b->invalidated = 0;
+    dev->backing = b;
+    return true;
+}
+
+static bool backing_contains(const ra8876_backing_entry_t *e, int32_t x, int32_t y, int32_t w, int32_t h) {
+    return x >= e->x && y >= e->y && x + w <= e->x + e->w && y + h <= e->y + e->h;
+}
+
+static bool backing_overlaps(const ra8876_backing_entry_t *e, int32_t x, int32_t y, int32_t w, int32_t h) {
+    return x < e->x + e->w && y < e->y + e->h && x + w > e->x && y + h > e->y;
+}
+
+void ra8876_backing_damage(ra8876_backing_t *b, uint32_t canvas, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (w <= 0 || h <= 0) return;
+    bool above = false;
+    for (int i = b->depth - 1; i >= 0; i--) {
+        ra8876_backing_entry_t *e = &b->stack[i];
+        if (e->canvas != canvas) continue;
+        if (backing_contains(e, x, y, w, h)) {
+            above = true;
+        } else if (!above && e->valid && backing_overlaps(e, x, y, w, h)) {
+            e->valid = false;
+            b->invalidated++;
+        }
+    }
+}
+
+bool ra8876_backing_push(ra8876_t *dev, ra8876_backing_t *b, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    if (x >= dev->width || y >= dev->height) return false;
+    if (w > dev->width - x) w = dev->width - x;
+    if (h > dev->height - y) h = dev->height - y;
+    if (w == 0 || h == 0 || b->depth == RA8876_BACKING_DEPTH) return false;
+
+    uint16_t px = 0, py = 0, shelf = h;
+    if (b->depth > 0) {
+        const ra8876_backing_entry_t *top = &b->stack[b->depth - 1];
+        if (top->pool_x + top->w + w <= dev->width && h <= top->shelf_h) {
+            px = top->pool_x + top->w;
+            py = top->pool_y;
+            shelf = top->shelf_h;
+        } else {
+            py = top->pool_y + top->shelf_h;
+        }
+    }
+    if (py + shelf > b->pool_rows) return false;
+
+    ra8876_backing_entry_t *e = &b->stack[b->depth++];
+    e->x = x;
+    e->y = y;
+    e->w = w;
+    e->h = h;
+    e->pool_x = px;
+    e->pool_y = py;
+    e->shelf_h = shelf;
+    e->canvas = dev->canvas_addr;
+    e->valid = true;
+
+    dev->backing = NULL;
+    ra8876_bte_copy(dev, e->canvas, x, y, b->pool_addr, px, py, w, h, RA8876_ROP_S);
+    dev->backing = b;
+    return true;
+}
+
+bool ra8876_backing_pop(ra8876_t *dev, ra8876_backing_t *b) {
+    if (b->depth == 0) return false;
+    const ra8876_backing_entry_t *e = &b->stack[--b->depth];
+    if (!e->valid) return false;
+
+    ra8876_rect_t clip;
+    clip_suspend(dev, &clip);
+    dev->backing = NULL;
+    ra8876_bte_copy(dev, b->pool_addr, e->pool_x, e->pool_y, e->canvas, e->x, e->y, e->w, e->h, RA8876_ROP_S);
+    dev->backing = b;
+    clip_resume(dev, &clip);
+    b->restored++;
+    return true;
+}
+
+static int32_t rect_area(ra8876_rect_t r) {
+    return (int32_t)r.w * r.h;
+}
+
+static ra8876_rect_t rect_union(ra8876_rect_t a, ra8876_rect_t b) {
+    if (a.w <= 0 || a.h <= 0) return b;
+    if (b.w <= 0 || b.h <= 0) return a;
+    int16_t x0 = a.x < b.x ? a.x : b.x, y0 = a.y < b.y ? a.y : b.y;
+    int16_t x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+    int16_t y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+    return (ra8876_rect_t){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+static bool rect_intersect(ra8876_rect_t a, ra8876_rect_t b, ra8876_rect_t *out) {
+    int16_t x0 = a.x > b.x ? a.x : b.x, y0 = a.y > b.y ? a.y : b.y;
+    int16_t x1 = a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w;
+    int16_t y1 = a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h;
+    if (x0 >= x1 || y0 >= y1) return false;
+    if (out) *out = (ra8876_rect_t){ x0, y0, x1 - x0, y1 - y0 };
+    return true;
+}
+
+static bool rect_inside(ra8876_rect_t inner, ra8876_rect_t outer) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
+
+void ra8876_ui_init(ra8876_ui_t *ui, uint32_t bg) {
+    ui->bg = bg;
+    ui->count = 0;
+    ui->damage_count = 0;
+    ui->redrawn = 0;
+}
+
+bool ra8876_ui_add(ra8876_ui_t *ui, ra8876_widget_t *w) {
+    if (ui->count == RA8876_UI_MAX_WIDGETS) return false;
+    ui->widgets[ui->count++] = w;
+    w->dirty = true;
+    w->damage = w->rect;
+    return true;
+}
+
+void ra8876_ui_damage(ra8876_ui_t *ui, int16_t x, int16_t y, int16_t w, int16_t h) {
+    ra8876_rect_t r = { x, y, w, h };
+    if (w <= 0 || h <= 0) return;
+
+    for (uint8_t i = 0; i < ui->damage_count;) {
+        ra8876_rect_t u = rect_union(r, ui->damage[i]);
+        if (rect_area(u) <= rect_area(r) + rect_area(ui->damage[i])) {
+            r = u;
+            ui->damage[i] = ui->damage[--ui->damage_count];
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+    if (ui->damage_count == RA8876_UI_DAMAGE_MAX) {
+        uint8_t best = 0;
+        int32_t best_growth = INT32_MAX;
+        for (uint8_t i = 0; i < ui->damage_count; i++) {
+            int32_t growth = rect_area(rect_union(r, ui->damage[i])) - rect_area(ui->damage[i]);
+            if (growth < best_growth) {
+                best_growth = growth;
+                best = i;
+            }
+        }
+        r = rect_union(r, ui->damage[best]);
+        ui->damage[best] = ui->damage[--ui->damage_count];
+        ra8876_ui_damage(ui, r.x, r.y, r.w, r.h);
+        return;
+    }
+    ui->damage[ui->damage_count++] = r;
+}
+
+static void widget_damage(ra8876_widget_t *w, ra8876_rect_t r) {
+    w->damage = w->dirty ? rect_union(w->damage, r) : r;
+    w->dirty = true;
+}
+
+void ra8876_widget_init(ra8876_widget_t *w, uint8_t type, int16_t x, int16_t y, int16_t width, int16_t height,
+                        uint32_t fg, uint32_t bg, uint32_t accent) {
+    memset(w, 0, sizeof(*w));
+    w->type = type;
+    w->rect = (ra8876_rect_t){ x, y, width, height };
+    w->fg = fg;
+    w->bg = bg;
+    w->accent = accent;
+    w->visible = true;
+    w->max = 100;
+    w->row_h = 24;
 }
 
-void ra8876_bte_mem_expand(ra8876_t *dev, uint32_t src_addr, uint16_t src_x, uint16_t src_y,
-                           uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
-                           uint16_t width, uint16_t height, uint32_t fg, uint32_t bg) {
-    ra8876_wait_task_busy(dev);
-    set_draw_color(dev, fg);
-    set_bg_draw_color(dev, bg);
-    bte_set_source0(dev, src_addr, dev->width, src_x, src_y);
-    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
-    bte_set_size(dev, width, height);
-    bte_start(dev, RA8876_ROP_S, 0x0E);
+void ra8876_widget_set_text(ra8876_widget_t *w, const char *s) {
+    if (strncmp(w->text, s, RA8876_UI_TEXT) == 0) return;
+    strncpy(w->text, s, RA8876_UI_TEXT);
+    w->text[RA8876_UI_TEXT] = 0;
+    widget_damage(w, w->rect);
 }
 
-void ra8876_bte_write_opacity(ra8876_t *dev, uint32_t s1_addr, uint16_t s1_x, uint16_t s1_y,
-                              uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
-                              uint16_t width, uint16_t height,
-                              const uint8_t *data, uint8_t alpha) {
-    ra8876_wait_task_busy(dev);
-    bte_set_source1(dev, s1_addr, dev->width, s1_x, s1_y);
-    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
-    bte_set_size(dev, width, height);
-    reg_wr(dev, RA8876_APB_CTRL, alpha >> 3);
-    bte_start_mpu(dev, RA8876_ROP_S, 0x0B);
-    while (ra8876_read_status(dev) & 0x80);
-    ra8876_write_data_burst(dev, data, (size_t)width * height );
-    bte_wait_mpu(dev);
+void ra8876_widget_set_range(ra8876_widget_t *w, int16_t min, int16_t max) {
+    if (min == w->min && max == w->max) return;
+    w->min = min;
+    w->max = max > min ? max : min + 1;
+    widget_damage(w, w->rect);
 }
 
-void ra8876_bte_pattern_fill(ra8876_t *dev, uint32_t pattern_addr,
-                             uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
-                             uint16_t width, uint16_t height,
-                             bool pattern_16x16, uint8_t rop) {
-    ra8876_wait_task_busy(dev);
-    bte_set_source0(dev, pattern_addr, dev->width, 0, 0);
-    bte_set_dest(dev, dst_addr, dev->width, dst_x, dst_y);
-    bte_set_size(dev, width, height);
-    bte_start_pattern(dev, rop, 0x06, pattern_16x16);
+static int16_t bar_level(const ra8876_widget_t *w, int16_t value) {
+    int16_t inner = w->rect.w - 4;
+    if (value <= w->min) return 0;
+    if (value >= w->max) return inner;
+    return (int32_t)(value - w->min) * inner / (w->max - w->min);
 }
 
-void ra8876_cursor_show(ra8876_t *dev, bool blink) {
-    dev->reg3C = (dev->reg3C & ~0x03) | 0x02 | (blink ? 0x01 : 0x00);
-    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+void ra8876_widget_set_value(ra8876_widget_t *w, int16_t value) {
+    if (value == w->value) return;
+    if (w->type == RA8876_WIDGET_BAR) {
+        int16_t a = bar_level(w, w->value), b = bar_level(w, value);
+        if (a != b) {
+            int16_t lo = a < b ? a : b;
+            widget_damage(w, (ra8876_rect_t){ w->rect.x + 2 + lo, w->rect.y + 2, (a > b ? a - b : b - a), w->rect.h - 4 });
+        }
+    } else {
+        widget_damage(w, w->rect);
+    }
+    w->value = value;
 }
 
-void ra8876_cursor_hide(ra8876_t *dev) {
-    dev->reg3C &= ~0x03;
-    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+static ra8876_rect_t list_row(const ra8876_widget_t *w, uint8_t index, uint16_t pitch) {
+    return (ra8876_rect_t){ w->rect.x + 1, w->rect.y + 1 + index * pitch, w->rect.w - 2, pitch };
 }
 
-void ra8876_cursor_size(ra8876_t *dev, uint8_t width, uint8_t height) {
-    reg_wr(dev, RA8876_CURHS, width - 1);
-    reg_wr(dev, RA8876_CURVS, height - 1);
+void ra8876_widget_set_items(ra8876_widget_t *w, const char *const *items, uint8_t count) {
+    w->items = items;
+    w->count = count;
+    if (w->selected >= count) w->selected = 0;
+    widget_damage(w, w->rect);
 }
 
-void ra8876_cursor_blink_rate(ra8876_t *dev, uint8_t frames) {
-    reg_wr(dev, RA8876_BTCR, frames);
+void ra8876_widget_select(ra8876_widget_t *w, uint8_t index) {
+    if (index == w->selected || index >= w->count) return;
+    widget_damage(w, list_row(w, w->selected, w->row_h));
+    widget_damage(w, list_row(w, index, w->row_h));
+    w->selected = index;
 }
 
-void ra8876_gcursor_enable(ra8876_t *dev, uint8_t set) {
-    dev->reg3C = (dev->reg3C & ~0x1C) | 0x10 | ((set & 0x03) << 2);
-    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+void ra8876_widget_set_pressed(ra8876_widget_t *w, bool pressed) {
+    if (pressed == w->pressed) return;
+    w->pressed = pressed;
+    widget_damage(w, w->rect);
 }
 
-void ra8876_gcursor_disable(ra8876_t *dev) {
-    dev->reg3C &= ~0x10;
-    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
+void ra8876_widget_set_visible(ra8876_ui_t *ui, ra8876_widget_t *w, bool visible) {
+    if (visible == w->visible) return;
+    w->visible = visible;
+    if (visible)
+        widget_damage(w, w->rect);
+    else
+        ra8876_ui_damage(ui, w->rect.x, w->rect.y, w->rect.w, w->rect.h);
 }
 
-void ra8876_gcursor_move(ra8876_t *dev, uint16_t x, uint16_t y) {
-    reg_wr16(dev, RA8876_GCHP, x);
-    reg_wr16(dev, RA8876_GCVP, y);
+void ra8876_widget_move(ra8876_ui_t *ui, ra8876_widget_t *w, int16_t x, int16_t y) {
+    if (x == w->rect.x && y == w->rect.y) return;
+    ra8876_ui_damage(ui, w->rect.x, w->rect.y, w->rect.w, w->rect.h);
+    w->rect.x = x;
+    w->rect.y = y;
+    widget_damage(w, w->rect);
 }
 
-void ra8876_gcursor_colors(ra8876_t *dev, uint8_t color0, uint8_t color1) {
-    reg_wr(dev, RA8876_GCC0, color0);
-    reg_wr(dev, RA8876_GCC1, color1);
+static void widget_text(ra8876_t *dev, int16_t x, int16_t y, uint32_t fg, uint32_t bg, const char *s) {
+    ra8876_set_text_colors(dev, fg, bg);
+    ra8876_set_text_cursor(dev, x, y);
+    ra8876_put_string(dev, s);
 }
 
-void ra8876_gcursor_load(ra8876_t *dev, uint8_t set, const uint8_t *data) {
-    dev->reg3C = (dev->reg3C & ~0x0C) | ((set & 0x03) << 2);
-    reg_wr(dev, RA8876_GTCCR, dev->reg3C);
-    dev->reg03 = (dev->reg03 & ~0x03) | 0x02;
-    reg_wr(dev, RA8876_ICR, dev->reg03);
-    cmd(dev, RA8876_MRWDP);
-    ra8876_write_data_burst(dev, data, 256);
-    dev->reg03 &= ~0x03;
-    reg_wr(dev, RA8876_ICR, dev->reg03);
+static void widget_draw(ra8876_t *dev, const ra8876_widget_t *w) {
+    ra8876_rect_t r = w->rect;
+    uint16_t pitch = ra8876_line_pitch(dev);
+    int16_t ty = r.y + (r.h - (int16_t)pitch) / 2;
+    int16_t tw = strlen(w->text) * ra8876_char_advance(dev);
+
+    switch (w->type) {
+        case RA8876_WIDGET_LABEL:
+            ra8876_fill_rect(dev, r.x, r.y, r.w, r.h, w->bg);
+            widget_text(dev, r.x, ty, w->fg, w->bg, w->text);
+            break;
+        case RA8876_WIDGET_BUTTON: {
+            uint32_t face = w->pressed ? w->accent : w->bg;
+            ra8876_fill_rect(dev, r.x, r.y, r.w, r.h, face);
+            ra8876_draw_rect(dev, r.x, r.y, r.w, r.h, w->fg);
+            widget_text(dev, r.x + (r.w - tw) / 2, ty, w->fg, face, w->text);
+            break;
+        }
+        case RA8876_WIDGET_GAUGE: {
+            int16_t rad = r.w / 2 - 4 < r.h - 24 ? r.w / 2 - 4 : r.h - 24;
+            int16_t cx = r.x + r.w / 2, cy = r.y + rad + 4;
+            float f = (float)(w->value - w->min) / (w->max - w->min);
+            if (f < 0) f = 0;
+            if (f > 1) f = 1;
+            float a = (float)M_PI * (1 + f);
+            ra8876_fill_rect(dev, r.x, r.y, r.w, r.h, w->bg);
+            ra8876_draw_curve(dev, cx, cy, rad, rad, RA8876_CURVE_UL, w->fg);
+            ra8876_draw_curve(dev, cx, cy, rad, rad, RA8876_CURVE_UR, w->fg);
+            ra8876_draw_line(dev, cx, cy, cx + (int16_t)((rad - 6) * cosf(a)), cy + (int16_t)((rad - 6) * sinf(a)), w->accent);
+            char buf[8];
+            snprintf(buf, sizeof(buf), "%d", w->value);
+            widget_text(dev, cx - (int16_t)(strlen(buf) * ra8876_char_advance(dev)) / 2, cy + 4, w->fg, w->bg, buf);
+            break;
+        }
+        case RA8876_WIDGET_BAR: {
+            int16_t level = bar_level(w, w->value);
+            ra8876_draw_rect(dev, r.x, r.y, r.w, r.h, w->fg);
+            ra8876_draw_rect(dev, r.x + 1, r.y + 1, r.w - 2, r.h - 2, w->bg);
+            if (level > 0) ra8876_fill_rect(dev, r.x + 2, r.y + 2, level, r.h - 4, w->accent);
+            if (level < r.w - 4) ra8876_fill_rect(dev, r.x + 2 + level, r.y + 2, r.w - 4 - level, r.h - 4, w->bg);
+            break;
+        }
+        case RA8876_WIDGET_LIST: {
+            uint16_t row = w->row_h;
+            ra8876_draw_rect(dev, r.x, r.y, r.w, r.h, w->fg);
+            for (uint8_t i = 0; i < w->count && (i + 1) * row <= r.h - 2; i++) {
+                ra8876_rect_t rr = list_row(w, i, row);
+                uint32_t face = i == w->selected ? w->accent : w->bg;
+                ra8876_fill_rect(dev, rr.x, rr.y, rr.w, rr.h, face);
+                widget_text(dev, rr.x + 6, rr.y + (row - pitch) / 2, w->fg, face, w->items[i]);
+            }
+            break;
+        }
+        default:
+            ra8876_fill_rect(dev, r.x, r.y, r.w, r.h, w->bg);
+            ra8876_draw_rect(dev, r.x, r.y, r.w, r.h, w->fg);
+            widget_text(dev, r.x + 4, ty, w->fg, w->bg, w->text);
+            ra8876_fill_rect(dev, r.x + 4 + tw, ty, 2, pitch, w->accent);
+            break;
+    }
 }
 
-void ra8876_invert_area(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
-    ra8876_wait_task_busy(dev);
-    uint32_t addr = dev->canvas_addr;
-    bte_set_source0(dev, addr, dev->width, x, y);
-    bte_set_dest(dev, addr, dev->width, x, y);
-    bte_set_size(dev, w, h);
-    bte_start(dev, RA8876_ROP_NOT_S, 0x02);
+uint16_t ra8876_ui_update(ra8876_t *dev, ra8876_ui_t *ui) {
+    for (uint8_t i = 0; i < ui->count; i++) {
+        ra8876_widget_t *w = ui->widgets[i];
+        if (!w->dirty) continue;
+        w->dirty = false;
+        if (w->visible) ra8876_ui_damage(ui, w->damage.x, w->damage.y, w->damage.w, w->damage.h);
+    }
+    if (ui->damage_count == 0) return 0;
+
+    uint16_t aw_x = dev->aw_x, aw_y = dev->aw_y, aw_w = dev->aw_w, aw_h = dev->aw_h;
+    ra8876_rect_t screen = { 0, 0, dev->width, dev->height };
+    uint16_t count = 0;
+
+    for (uint8_t d = 0; d < ui->damage_count; d++) {
+        ra8876_rect_t r;
+        if (!rect_intersect(ui->damage[d], screen, &r)) continue;
+        ra8876_set_active_window(dev, r.x, r.y, r.w, r.h);
+
+        bool covered = false;
+        for (uint8_t i = 0; i < ui->count && !covered; i++) {
+            const ra8876_widget_t *w = ui->widgets[i];
+            covered = w->visible && w->type != RA8876_WIDGET_LIST && rect_inside(r, w->rect);
+        }
+        if (!covered) ra8876_fill_rect(dev, r.x, r.y, r.w, r.h, ui->bg);
+
+        for (uint8_t i = 0; i < ui->count; i++) {
+            const ra8876_widget_t *w = ui->widgets[i];
+            if (w->visible && rect_intersect(r, w->rect, NULL)) widget_draw(dev, w);
+        }
+        count++;
+    }
+
+    ra8876_set_active_window(dev, aw_x, aw_y, aw_w, aw_h);
+    ui->damage_count = 0;
+    ui->redrawn += count;
+    return count;
 }
 
-void ra8876_pip1_enable(ra8876_t *dev, uint32_t src_addr, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
-    dev->reg10 &= ~0x10;
-    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
-    reg_wr32(dev, RA8876_PISA, src_addr);
-    reg_wr16(dev, RA8876_PIW, dev->width);
-    reg_wr16(dev, RA8876_PWDULX, x);
-    reg_wr16(dev, RA8876_PWDULY, y);
-    reg_wr16(dev, RA8876_PWIULX, 0);
-    reg_wr16(dev, RA8876_PWIULY, 0);
-    reg_wr16(dev, RA8876_PWW, w);
-    reg_wr16(dev, RA8876_PWH, h);
-    dev->reg10 |= 0x80;
-    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+void ra8876_frame_begin(ra8876_frame_t *f, uint32_t addr) {
+    f->addr = addr;
+    f->count = 0;
+    f->ops_in = 0;
+    f->ops_out = 0;
+    f->px_in = 0;
+    f->px_out = 0;
 }
 
-void ra8876_pip1_move(ra8876_t *dev, uint16_t x, uint16_t y) {
-    dev->reg10 &= ~0x10;
-    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
-    reg_wr16(dev, RA8876_PWDULX, x);
-    reg_wr16(dev, RA8876_PWDULY, y);
+static void frame_add(ra8876_t *dev, ra8876_frame_t *f, uint32_t src_addr, int32_t sx, int32_t sy,
+                      int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    int32_t x0 = x, y0 = y;
+    if (y + h > dev->height) h = dev->height - y;
+    if (!clip_box(dev, f->addr, &x0, &y0, &w, &h)) return;
+    if (f->count == RA8876_FRAME_MAX) ra8876_frame_flush(dev, f);
+    ra8876_frame_item_t *it = &f->items[f->count++];
+    it->rect = (ra8876_rect_t){ x0, y0, w, h };
+    it->src_addr = src_addr;
+    it->src_x = sx + x0 - x;
+    it->src_y = sy + y0 - y;
+    it->color = color;
+    f->ops_in++;
+    f->px_in += rect_area(it->rect);
 }
 
-void ra8876_pip1_disable(ra8876_t *dev) {
-    dev->reg10 &= ~0x80;
-    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+void ra8876_frame_fill(ra8876_t *dev, ra8876_frame_t *f, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    frame_add(dev, f, RA8876_SDRAM_NONE, 0, 0, x, y, w, h, color);
 }
 
-void ra8876_pip2_enable(ra8876_t *dev, uint32_t src_addr, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
-    dev->reg10 |= 0x10;
-    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
-    reg_wr32(dev, RA8876_PISA, src_addr);
-    reg_wr16(dev, RA8876_PIW, dev->width);
-    reg_wr16(dev, RA8876_PWDULX, x);
-    reg_wr16(dev, RA8876_PWDULY, y);
-    reg_wr16(dev, RA8876_PWIULX, 0);
-    reg_wr16(dev, RA8876_PWIULY, 0);
-    reg_wr16(dev, RA8876_PWW, w);
-    reg_wr16(dev, RA8876_PWH, h);
-    dev->reg10 |= 0x40;
-    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+void ra8876_frame_copy(ra8876_t *dev, ra8876_frame_t *f, uint32_t src_addr, int32_t src_x, int32_t src_y,
+                       int32_t x, int32_t y, int32_t w, int32_t h) {
+    frame_add(dev, f, src_addr, src_x, src_y, x, y, w, h, 0);
 }
 
-void ra8876_pip2_move(ra8876_t *dev, uint16_t x, uint16_t y) {
-    dev->reg10 |= 0x10;
-    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
-    reg_wr16(dev, RA8876_PWDULX, x);
-    reg_wr16(dev, RA8876_PWDULY, y);
+static bool frame_reads(const ra8876_frame_t *f, const ra8876_frame_item_t *it, ra8876_rect_t r) {
+    if (it->src_addr != f->addr || it->rect.w <= 0) return false;
+    ra8876_rect_t src = { it->src_x, it->src_y, it->rect.w, it->rect.h };
+    return rect_intersect(src, r, NULL);
 }
 
-void ra8876_pip2_disable(ra8876_t *dev) {
-    dev->reg10 &= ~0x40;
-    reg_wr(dev, RA8876_MPWCTR, dev->reg10);
+static uint8_t rect_subtract(ra8876_rect_t a, ra8876_rect_t b, ra8876_rect_t *out) {
+    ra8876_rect_t c;
+    if (!rect_intersect(a, b, &c)) {
+        out[0] = a;
+        return 1;
+    }
+    uint8_t n = 0;
+    if (c.y > a.y) out[n++] = (ra8876_rect_t){ a.x, a.y, a.w, c.y - a.y };
+    if (c.y + c.h < a.y + a.h) out[n++] = (ra8876_rect_t){ a.x, c.y + c.h, a.w, a.y + a.h - c.y - c.h };
+    if (c.x > a.x) out[n++] = (ra8876_rect_t){ a.x, c.y, c.x - a.x, c.h };
+    if (c.x + c.w < a.x + a.w) out[n++] = (ra8876_rect_t){ c.x + c.w, c.y, a.x + a.w - c.x - c.w, c.h };
+    return n;
 }
 
-static uint32_t cgram_addr(ra8876_t *dev) {
-    (void)dev;
-    return RA8876_SDRAM_SIZE - 65536;
+static uint8_t frame_visible(ra8876_frame_t *f, uint16_t i, ra8876_rect_t *pieces) {
+    uint8_t n = 1;
+    pieces[0] = f->items[i].rect;
+    for (uint16_t j = i + 1; j < f->count && n > 0; j++) {
+        const ra8876_frame_item_t *o = &f->items[j];
+        bool barrier = false;
+        for (uint8_t k = 0; k < n && !barrier; k++)
+            barrier = frame_reads(f, o, pieces[k]);
+        if (barrier) break;
+        ra8876_rect_t next[RA8876_FRAME_PIECES + 4];
+        uint8_t m = 0;
+        int32_t saved = 0;
+        for (uint8_t k = 0; k < n && m <= RA8876_FRAME_PIECES; k++) {
+            ra8876_rect_t c;
+            if (rect_intersect(pieces[k], o->rect, &c)) saved += rect_area(c);
+            m += rect_subtract(pieces[k], o->rect, &next[m]);
+        }
+        if (saved == 0 || m > RA8876_FRAME_PIECES) continue;
+        if (m > n && saved < (int32_t)(m - n) * RA8876_FRAME_SPLIT_MIN) continue;
+        memcpy(pieces, next, m * sizeof(ra8876_rect_t));
+        n = m;
+    }
+    return n;
 }
 
-void ra8876_cgram_init(ra8876_t *dev) {
-    reg_wr32(dev, RA8876_CGRAM_STR, cgram_addr(dev));
+static void frame_occlude(ra8876_frame_t *f) {
+    for (uint16_t i = 0; i < f->count; i++) {
+        ra8876_frame_item_t *it = &f->items[i];
+        ra8876_rect_t pieces[RA8876_FRAME_PIECES];
+        uint8_t n = frame_visible(f, i, pieces);
+        if (n == 0) {
+            it->rect.w = 0;
+            continue;
+        }
+        if (n > 1 && (f->count + n - 1 > RA8876_FRAME_MAX || it->src_addr == f->addr)) {
+            for (uint8_t k = 1; k < n; k++)
+                pieces[0] = rect_union(pieces[0], pieces[k]);
+            n = 1;
+        }
+        ra8876_frame_item_t base = *it;
+        memmove(&f->items[i + n], &f->items[i + 1], (f->count - i - 1) * sizeof(ra8876_frame_item_t));
+        f->count += n - 1;
+        for (uint8_t k = 0; k < n; k++) {
+            ra8876_frame_item_t *p = &f->items[i + k];
+            *p = base;
+            p->rect = pieces[k];
+            p->src_x += pieces[k].x - base.rect.x;
+            p->src_y += pieces[k].y - base.rect.y;
+        }
+        i += n - 1;
+    }
 }
 
-void ra8876_cgram_upload_font(ra8876_t *dev, const uint8_t *data, uint8_t first_char, uint8_t num_chars, uint8_t font_height) {
-    uint32_t bytes_per_char;
-    switch (font_height) {
-        case 24: bytes_per_char = 48; break;
-        case 32: bytes_per_char = 64; break;
-        default: bytes_per_char = 16; break;
+static bool frame_can_hoist(ra8876_frame_t *f, uint16_t i, uint16_t j) {
+    ra8876_rect_t r = f->items[j].rect;
+    for (uint16_t k = i + 1; k < j; k++) {
+        const ra8876_frame_item_t *o = &f->items[k];
+        if (o->rect.w > 0 && (rect_intersect(o->rect, r, NULL) || frame_reads(f, o, r))) return false;
     }
+    return true;
+}
 
-    uint32_t addr = cgram_addr(dev) + first_char * bytes_per_char;
-    uint32_t total = num_chars * bytes_per_char;
+static void frame_merge(ra8876_frame_t *f) {
+    for (uint16_t i = 0; i < f->count; i++) {
+        ra8876_frame_item_t *a = &f->items[i];
+        if (a->rect.w <= 0 || a->src_addr != RA8876_SDRAM_NONE) continue;
+        for (uint16_t j = i + 1; j < f->count; j++) {
+            ra8876_frame_item_t *b = &f->items[j];
+            if (b->rect.w <= 0 || b->src_addr != RA8876_SDRAM_NONE || b->color != a->color) continue;
+            ra8876_rect_t u = rect_union(a->rect, b->rect), c;
+            int32_t overlap = rect_intersect(a->rect, b->rect, &c) ? rect_area(c) : 0;
+            if (rect_area(u) != rect_area(a->rect) + rect_area(b->rect) - overlap) continue;
+            if (!frame_can_hoist(f, i, j)) continue;
+            a->rect = u;
+            b->rect.w = 0;
+            j = i;
+        }
+    }
+}
 
-    ra8876_wait_task_busy(dev);
-    reg_wr(dev, RA8876_AW_COLOR, 0x04);
-    reg_wr32(dev, RA8876_CURH, addr);
-    cmd(dev, RA8876_MRWDP);
+void ra8876_frame_flush(ra8876_t *dev, ra8876_frame_t *f) {
+    frame_occlude(f);
+    frame_merge(f);
+    for (uint16_t i = 0; i < f->count; i++) {
+        const ra8876_frame_item_t *it = &f->items[i];
+        const ra8876_rect_t *r = &it->rect;
+        if (r->w <= 0) continue;
+        if (it->src_addr == RA8876_SDRAM_NONE)
+            ra8876_bte_solid_fill_s(dev, f->addr, r->x, r->y, r->w, r->h, it->color);
+        else
+            ra8876_bte_copy_s(dev, it->src_addr, it->src_x, it->src_y, f->addr, r->x, r->y, r->w, r->h, RA8876_ROP_S);
+        f->ops_out++;
+        f->px_out += rect_area(*r);
+    }
+    f->count = 0;
+}
 
-    while (ra8876_read_status(dev) & 0x80);
-    ra8876_write_data_burst(dev, data, total);
+static void core1_worker(void) {
+    while (1) {
+        void (*fn)(void *) = (void (*)(void *))(uintptr_t)multicore_fifo_pop_blocking();
+        void *arg = (void *)(uintptr_t)multicore_fifo_pop_blocking();
+        fn(arg);
+        multicore_fifo_push_blocking(1);
+    }
+}
 
-    ra8876_wait_write_fifo_empty(dev);
-    ra8876_wait_task_busy(dev);
-    reg_wr(dev, RA8876_AW_COLOR, 0x00);
-    cmd(dev, RA8876_CHIP_ID);
+void ra8876_core1_start(void) {
+    if (core1_running) return;
+    multicore_launch_core1(core1_worker);
+    core1_running = true;
 }
 
-void ra8876_cgram_upload_inv_font(ra8876_t *dev, const uint8_t *data, uint8_t first_char, uint8_t num_chars, uint8_t font_height) {
-    uint32_t bytes_per_char;
-    switch (font_height) {
-        case 24: bytes_per_char = 48; break;
-        case 32: bytes_per_char = 64; break;
-        default: bytes_per_char = 16; break;
+void ra8876_core1_run(void (*fn)(void *), void *arg) {
+    multicore_fifo_push_blocking((uint32_t)(uintptr_t)fn);
+    multicore_fifo_push_blocking((uint32_t)(uintptr_t)arg);
+}
+
+void ra8876_core1_wait(void) {
+    multicore_fifo_pop_blocking();
+}
+
+#define TILE_DIRTY  0x01
+#define TILE_VALID  0x02
+#define TILE_SHOWN  0x04
+
+typedef struct {
+    ra8876_tiles_t *t;
+    uint8_t slot;
+} tile_job_t;
+
+static tile_job_t tile_jobs[2];
+
+static void tiles_set_state(ra8876_tiles_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                            uint8_t set, uint8_t clear) {
+    if (w == 0 || h == 0) return;
+    if (x >= t->x + t->w || y >= t->y + t->h || x + w <= t->x || y + h <= t->y) return;
+    uint16_t x0 = x > t->x ? x - t->x : 0;
+    uint16_t y0 = y > t->y ? y - t->y : 0;
+    uint16_t x1 = x + w < t->x + t->w ? x + w - t->x : t->w;
+    uint16_t y1 = y + h < t->y + t->h ? y + h - t->y : t->h;
+    for (uint16_t ty = y0 / RA8876_TILE_SIZE; ty <= (y1 - 1) / RA8876_TILE_SIZE; ty++) {
+        for (uint16_t tx = x0 / RA8876_TILE_SIZE; tx <= (x1 - 1) / RA8876_TILE_SIZE; tx++) {
+            uint8_t *st = &t->state[ty * t->cols + tx];
+            *st = (*st & ~clear) | set;
+        }
     }
+}
 
-    uint32_t addr = cgram_addr(dev) + (256 + first_char) * bytes_per_char;
+bool ra8876_tiles_init(ra8876_t *dev, ra8876_tiles_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                       ra8876_tile_fn fn, void *ctx) {
+    uint16_t cols = (w + RA8876_TILE_SIZE - 1) / RA8876_TILE_SIZE;
+    uint16_t rows = (h + RA8876_TILE_SIZE - 1) / RA8876_TILE_SIZE;
+    if (w == 0 || h == 0 || cols * rows > RA8876_TILE_MAX) return false;
+
+    t->x = x;
+    t->y = y;
+    t->w = w;
+    t->h = h;
+    t->cols = cols;
+    t->rows = rows;
+    t->pixel_bytes = ra8876_pixel_bytes(dev);
+    t->keyed = false;
+    t->dual = false;
+    t->bg = RA8876_BLACK;
+    t->fn = fn;
+    t->ctx = ctx;
+    t->rendered = 0;
+    t->uploaded = 0;
+    memset(t->state, TILE_DIRTY, sizeof(t->state));
+    return true;
+}
 
-    ra8876_wait_task_busy(dev);
-    reg_wr(dev, RA8876_AW_COLOR, 0x04);
-    reg_wr32(dev, RA8876_CURH, addr);
-    cmd(dev, RA8876_MRWDP);
+void ra8876_tiles_set_background(ra8876_tiles_t *t, uint32_t color, bool keyed) {
+    if (color != t->bg || keyed != t->keyed)
+        tiles_set_state(t, t->x, t->y, t->w, t->h, TILE_DIRTY, TILE_VALID);
+    t->bg = color;
+    t->keyed = keyed;
+}
 
-    while (ra8876_read_status(dev) & 0x80);
+void ra8876_tiles_set_dual_core(ra8876_tiles_t *t, bool enable) {
+    if (enable) ra8876_core1_start();
+    t->dual = enable;
+}
 
-    uint8_t inv[64];
-    for (uint8_t c = 0; c < num_chars; c++) {
-        for (uint32_t i = 0; i < bytes_per_char; i++)
-            inv[i] = ~data[c * bytes_per_char + i];
-        ra8876_write_data_burst(dev, inv, bytes_per_char);
+void ra8876_tiles_mark(ra8876_tiles_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    tiles_set_state(t, x, y, w, h, TILE_DIRTY, 0);
+}
+
+void ra8876_tiles_invalidate(ra8876_tiles_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    tiles_set_state(t, x, y, w, h, TILE_DIRTY, TILE_VALID);
+}
+
+static uint32_t tile_hash(const uint8_t *p, size_t len) {
+    uint32_t h = 2166136261u;
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        uint32_t w;
+        memcpy(&w, p + i, 4);
+        h = (h ^ w) * 16777619u;
     }
+    for (; i < len; i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
 
-    ra8876_wait_write_fifo_empty(dev);
-    ra8876_wait_task_busy(dev);
-    reg_wr(dev, RA8876_AW_COLOR, 0x00);
-    cmd(dev, RA8876_CHIP_ID);
+static void tile_rect(ra8876_tiles_t *t, uint16_t i, uint16_t *x, uint16_t *y, uint16_t *w, uint16_t *h) {
+    *x = (i % t->cols) * RA8876_TILE_SIZE;
+    *y = (i / t->cols) * RA8876_TILE_SIZE;
+    *w = t->w - *x < RA8876_TILE_SIZE ? t->w - *x : RA8876_TILE_SIZE;
+    *h = t->h - *y < RA8876_TILE_SIZE ? t->h - *y : RA8876_TILE_SIZE;
 }
 
-void ra8876_cgram_upload_cursor_font(ra8876_t *dev, const uint8_t *data, uint8_t first_char, uint8_t num_chars, uint8_t font_height) {
-    uint32_t bytes_per_char;
-    switch (font_height) {
-        case 24: bytes_per_char = 48; break;
-        case 32: bytes_per_char = 64; break;
-        default: bytes_per_char = 16; break;
+static void tile_render(ra8876_tiles_t *t, uint8_t slot) {
+    uint16_t x, y, w, h;
+    tile_rect(t, t->slot_tile[slot], &x, &y, &w, &h);
+    uint8_t *buf = t->buf[slot];
+    uint8_t pb = t->pixel_bytes;
+    uint16_t stride = w * pb;
+    size_t bytes = (size_t)stride * h;
+
+    if (pb == 1) {
+        memset(buf, t->bg_px[0], bytes);
+    } else {
+        for (size_t i = 0; i < bytes; i += pb)
+            memcpy(buf + i, t->bg_px, pb);
     }
+    t->slot_drawn[slot] = t->fn(t->ctx, t->x + x, t->y + y, w, h, buf, stride);
+    t->slot_hash[slot] = t->slot_drawn[slot] ? tile_hash(buf, bytes) : 0;
+}
 
-    uint32_t addr = cgram_addr(dev) + (512 + first_char) * bytes_per_char;
+static void tile_job(void *arg) {
+    tile_job_t *job = arg;
+    tile_render(job->t, job->slot);
+}
 
-    ra8876_wait_task_busy(dev);
-    reg_wr(dev, RA8876_AW_COLOR, 0x04);
-    reg_wr32(dev, RA8876_CURH, addr);
-    cmd(dev, RA8876_MRWDP);
+static void tile_job_start(ra8876_tiles_t *t, uint8_t slot) {
+    tile_jobs[slot].t = t;
+    tile_jobs[slot].slot = slot;
+    ra8876_core1_run(tile_job, &tile_jobs[slot]);
+}
 
-    while (ra8876_read_status(dev) & 0x80);
+static void tile_commit(ra8876_t *dev, ra8876_tiles_t *t, uint8_t slot, uint32_t dst_addr) {
+    uint16_t i = t->slot_tile[slot];
+    uint8_t st = t->state[i] & ~TILE_DIRTY;
+    bool drawn = t->slot_drawn[slot];
 
-    uint8_t buf[64];
-    for (uint8_t c = 0; c < num_chars; c++) {
-        buf[0] = 0xFF;
-        buf[1] = 0x00;
-        for (uint32_t i = 2; i < bytes_per_char - 2; i++)
-            buf[i] = ~data[c * bytes_per_char + i];
-        buf[bytes_per_char - 2] = 0x00;
-        buf[bytes_per_char - 1] = 0xFF;
-        ra8876_write_data_burst(dev, buf, bytes_per_char);
+    t->rendered++;
+    if (!drawn && !(st & TILE_SHOWN)) {
+        t->state[i] = st | TILE_VALID;
+        t->hash[i] = 0;
+        return;
+    }
+    if (drawn && !t->keyed && (st & TILE_VALID) && (st & TILE_SHOWN) && t->hash[i] == t->slot_hash[slot]) {
+        t->state[i] = st;
+        return;
     }
 
-    ra8876_wait_write_fifo_empty(dev);
-    ra8876_wait_task_busy(dev);
-    reg_wr(dev, RA8876_AW_COLOR, 0x00);
-    cmd(dev, RA8876_CHIP_ID);
+    t->hash[i] = t->slot_hash[slot];
+    t->state[i] = TILE_VALID | (drawn ? TILE_SHOWN : 0);
+    if (!drawn && t->keyed) return;
+
+    uint16_t x, y, w, h;
+    ra8876_rect_t clip;
+    tile_rect(t, i, &x, &y, &w, &h);
+    clip_suspend(dev, &clip);
+    if (t->keyed)
+        ra8876_bte_write_chroma(dev, dst_addr, t->x + x, t->y + y, w, h, t->buf[slot], t->bg);
+    else
+        ra8876_bte_write(dev, dst_addr, t->x + x, t->y + y, w, h, t->buf[slot]);
+    clip_resume(dev, &clip);
+    t->uploaded++;
 }
 
-void ra8876_select_cgram_font(ra8876_t *dev, uint8_t size) {
-    switch (size) {
-        case RA8876_FONT_24: dev->char_width = 12; dev->char_height = 24; break;
-        case RA8876_FONT_32: dev->char_width = 16; dev->char_height = 32; break;
-        default: dev->char_width = 8; dev->char_height = 16; break;
-    }
-    reg_wr32(dev, RA8876_CGRAM_STR, cgram_addr(dev));
-    dev->regCC = 0x80 | ((size & 0x03) << 4);
-    reg_wr(dev, RA8876_CCR0, dev->regCC);
+static int tiles_next(ra8876_tiles_t *t, int from) {
+    int count = t->cols * t->rows;
+    for (int i = from; i < count; i++)
+        if (t->state[i] & TILE_DIRTY) return i;
+    return -1;
 }
 
-void ra8876_put_cgram_string_off(ra8876_t *dev, const char *str, uint8_t offset) {
-    ra8876_set_text_mode(dev);
-    cmd(dev, RA8876_MRWDP);
-    uint8_t buf[64];
-    while (*str) {
-        size_t n = 0;
-        while (*str && n < 64) {
-            buf[n++] = offset;
-            buf[n++] = *str++;
+void ra8876_tiles_update(ra8876_t *dev, ra8876_tiles_t *t, uint32_t dst_addr) {
+    uint8_t pb = ra8876_pixel_bytes(dev);
+    if (pb != t->pixel_bytes) {
+        t->pixel_bytes = pb;
+        tiles_set_state(t, t->x, t->y, t->w, t->h, TILE_DIRTY, TILE_VALID);
+    }
+    ra8876_put_pixel(dev, t->bg_px, t->bg);
+    t->rendered = 0;
+    t->uploaded = 0;
+
+    int cur = tiles_next(t, 0);
+    if (cur < 0) return;
+    uint8_t slot = 0;
+    t->slot_tile[0] = cur;
+    if (t->dual) tile_job_start(t, 0);
+
+    while (cur >= 0) {
+        int next = tiles_next(t, cur + 1);
+        if (t->dual) {
+            ra8876_core1_wait();
+            if (next >= 0) {
+                t->slot_tile[slot ^ 1] = next;
+                tile_job_start(t, slot ^ 1);
+            }
+        } else {
+            tile_render(t, slot);
+            if (next >= 0) t->slot_tile[slot ^ 1] = next;
         }
-        ra8876_write_data_burst(dev, buf, n);
+        tile_commit(dev, t, slot, dst_addr);
+        cur = next;
+        slot ^= 1;
     }
-    ra8876_set_graphics_mode(dev);
-}
-
-void ra8876_put_cgram_string(ra8876_t *dev, const char *str) {
-    ra8876_put_cgram_string_off(dev, str, 0);
 }
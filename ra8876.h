@@ -5,9 +5,53 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "hardware/spi.h"
+#include "hardware/pio.h"
 
 #define RA8876_SDRAM_SIZE   (16 * 1024 * 1024)
 #define RA8876_BURST_SIZE   20
+#define RA8876_FIELD_MAX    32
+#define RA8876_FIELD_MERGE_GAP 8
+#define RA8876_SDRAM_NONE   0xFFFFFFFF
+#define RA8876_SDRAM_BLOCKS 16
+#define RA8876_CHART_MAX_TRACES 4
+#define RA8876_CHART_SEGMENT 32
+#define RA8876_POLYGON_MAX  64
+#define RA8876_RLE_MAGIC    "RLE8"
+#define RA8876_RLE_HEADER   10
+#define RA8876_RLE_CHUNK    256
+#define RA8876_RUN_OPEN_MAX 32
+#define RA8876_RUN_ROW_MAX  1024
+#define RA8876_RUN_LOOKAHEAD 16
+#define RA8876_CONV_CHUNK   256
+#define RA8876_TILE_SIZE    64
+#define RA8876_TILE_MAX     160
+#define RA8876_TILE_BYTES   (RA8876_TILE_SIZE * RA8876_TILE_SIZE * 3)
+#define RA8876_AA_CHUNK     64
+#define RA8876_AA_LEVELS    4
+#define RA8876_TRANS_BAND   40
+#define RA8876_TRANS_BLOCK  32
+#define RA8876_BACKING_DEPTH 8
+#define RA8876_UI_MAX_WIDGETS 32
+#define RA8876_UI_DAMAGE_MAX 8
+#define RA8876_UI_TEXT      24
+#define RA8876_CLIP_DEPTH   8
+#define RA8876_COORD_MAX    8191
+#define RA8876_FRAME_MAX    96
+#define RA8876_FRAME_PIECES 4
+#define RA8876_FRAME_SPLIT_MIN 4096
+#define RA8876_STREAM_MAX   48
+#define RA8876_PATTERN_MAX  64
+#define RA8876_PATTERN_NONE (-1)
+#define RA8876_GRADIENT_DITHER_MIN 8
+#define RA8876_SPI_CAL_STEP 5000000
+#define RA8876_SPI_CAL_MARGIN 15
+#define RA8876_SPI_CAL_PASSES 4
+#define RA8876_SPI_CAL_BYTES 256
+#define RA8876_SPI_CAL_MAGIC 0x52414331
+
+#define RA8876_DITHER_NONE  0
+#define RA8876_DITHER_BAYER 1
+#define RA8876_DITHER_FS    2
 
 typedef enum {
     RA8876_SRR          = 0x00,
@@ -151,6 +195,7 @@ typedef enum {
 #define RA8876_ROP_S_AND_D     0x80
 #define RA8876_ROP_S           0xC0
 #define RA8876_ROP_NOT_S       0x30
+#define RA8876_ROP_NOT_S_AND_D 0x20
 #define RA8876_ROP_D           0xA0
 #define RA8876_ROP_NOT_D       0x50
 #define RA8876_ROP_S_XOR_D     0x60
@@ -162,23 +207,82 @@ typedef enum {
 #define RA8876_DIR_TB_LR       2
 #define RA8876_DIR_BT_LR       3
 
+#define RA8876_TRANS_CROSSFADE 0
+#define RA8876_TRANS_WIPE      1
+#define RA8876_TRANS_SLIDE     2
+#define RA8876_TRANS_DISSOLVE  3
+
+#define RA8876_TRANS_LEFT      0
+#define RA8876_TRANS_RIGHT     1
+#define RA8876_TRANS_UP        2
+#define RA8876_TRANS_DOWN      3
+
+#define RA8876_WIDGET_LABEL    0
+#define RA8876_WIDGET_BUTTON   1
+#define RA8876_WIDGET_GAUGE    2
+#define RA8876_WIDGET_BAR      3
+#define RA8876_WIDGET_LIST     4
+#define RA8876_WIDGET_FIELD    5
+
 #define RA8876_CURVE_BL        0x00
 #define RA8876_CURVE_UL        0x01
 #define RA8876_CURVE_UR        0x02
 #define RA8876_CURVE_BR        0x03
 
+#define RA8876_UNKNOWN_POS     0xFFFF
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} ra8876_rect_t;
+
+typedef struct {
+    uint32_t addr;
+    uint32_t bytes;
+    bool live;
+} ra8876_sdram_block_t;
+
+enum {
+    RA8876_CYCLE_CMD    = 0x00,
+    RA8876_CYCLE_STATUS = 0x40,
+    RA8876_CYCLE_DATA   = 0x80,
+    RA8876_CYCLE_READ   = 0xC0,
+};
+
+struct ra8876;
+
 typedef struct {
+    const char *name;
+    bool (*open)(struct ra8876 *dev);
+    void (*close)(struct ra8876 *dev);
+    void (*write)(struct ra8876 *dev, uint8_t cycle, const uint8_t *data, size_t len);
+    uint8_t (*read)(struct ra8876 *dev, uint8_t cycle);
+    void (*write_frames)(struct ra8876 *dev, const uint16_t *frames, size_t count);
+} ra8876_transport_t;
+
+typedef struct ra8876 {
+    const ra8876_transport_t *transport;
     spi_inst_t *spi;
     uint8_t pin_miso;
     uint8_t pin_cs;
     uint8_t pin_sck;
     uint8_t pin_mosi;
     uint32_t spi_speed;
+    PIO pio;
+    uint8_t pin_data;
+    uint8_t pin_wr;
+    uint32_t pio_speed;
+    uint8_t bpp;
 
     uint16_t width;
     uint16_t height;
     uint32_t page_size;
     uint8_t max_pages;
+    uint32_t sdram_top;
+    ra8876_sdram_block_t sdram_block[RA8876_SDRAM_BLOCKS];
+    uint8_t sdram_blocks;
 
     uint16_t char_width;
     uint16_t char_height;
@@ -193,15 +297,268 @@ typedef struct {
     uint8_t reg02;
     uint8_t reg03;
     uint8_t reg10;
+    uint8_t reg11;
     uint8_t reg3C;
+    uint8_t reg5E;
+    uint8_t reg92;
     uint8_t regCC;
     uint8_t regCD;
+    uint8_t regD0;
+    uint8_t regD1;
+
+    uint32_t fg_color;
+    uint32_t bg_color;
+    uint16_t text_x;
+    uint16_t text_y;
+    uint8_t text_batch;
+    bool text_stale;
+
+    uint16_t aw_x;
+    uint16_t aw_y;
+    uint16_t aw_w;
+    uint16_t aw_h;
+
+    uint32_t spi_bytes;
+    uint32_t spi_floor;
+    uint32_t link_errors;
+    uint32_t ops_submitted;
+    uint32_t ops_culled;
+    uint32_t ops_trimmed;
+
+    ra8876_rect_t clip;
+    ra8876_rect_t clip_stack[RA8876_CLIP_DEPTH];
+    uint8_t clip_depth;
+    uint16_t batch_w;
+    uint16_t batch_h;
+    uint16_t batch_x;
+    uint16_t batch_y;
+    bool batch_pos;
+    uint32_t wr_row_bytes;
+    uint32_t wr_pos;
+    uint32_t wr_vis0;
+    uint32_t wr_vis1;
+    uint16_t wr_row;
+    uint16_t wr_row0;
+    uint16_t wr_row1;
+    bool wr_clip;
+
+    uint16_t pt_regs[6];
+    uint8_t pt_valid;
+
+    int dma_chan;
+    bool dma_busy;
+    uint8_t pio_sm;
+    uint8_t pio_offset;
+    int pio_dma;
+    uint32_t pio_buf[RA8876_STREAM_MAX + (RA8876_BURST_SIZE + 6) / 4];
+    uint16_t stream[RA8876_STREAM_MAX];
+    uint8_t stream_len;
+    uint8_t stream_depth;
+    bool stream_off;
+    uint32_t aa_addr;
+    struct ra8876_backing *backing;
 
     uint8_t burst_buf[RA8876_BURST_SIZE + 1];
 } ra8876_t;
 
+extern const ra8876_transport_t ra8876_spi_transport;
+extern const ra8876_transport_t ra8876_pio_spi_transport;
+extern const ra8876_transport_t ra8876_pio_8080_transport;
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+} ra8876_point_t;
+
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint32_t color;
+    const char *s;
+} ra8876_text_run_t;
+
+typedef struct {
+    uint32_t ring_addr;
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint8_t num_traces;
+    bool autoscale;
+    bool redraw;
+    int16_t lo;
+    int16_t hi;
+    uint16_t grid_step;
+    uint16_t pending;
+    uint32_t total;
+    uint32_t bg;
+    uint32_t grid;
+    uint32_t colors[RA8876_CHART_MAX_TRACES];
+    int16_t *history;
+} ra8876_chart_t;
+
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint8_t width;
+    bool valid;
+    uint32_t fg;
+    uint32_t bg;
+    char text[RA8876_FIELD_MAX + 1];
+} ra8876_field_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint8_t pixel_bytes;
+} ra8876_rle_info_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t x;
+    uint16_t y;
+    uint8_t out_bytes;
+    uint8_t dither;
+    int16_t *err;
+    int16_t carry[3];
+    int16_t pending[3];
+} ra8876_conv_t;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t dir;
+    uint8_t from_page;
+    uint8_t to_page;
+    uint8_t work_page[2];
+    uint8_t back;
+    uint8_t state;
+    uint32_t start_us;
+    uint32_t duration_us;
+    uint32_t budget_us;
+    uint16_t progress;
+    uint16_t target;
+    uint16_t shown[2];
+    uint16_t unit;
+    uint16_t units;
+    uint16_t blocks;
+    uint16_t step;
+    uint16_t frames;
+} ra8876_transition_t;
+
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint16_t pool_x;
+    uint16_t pool_y;
+    uint16_t shelf_h;
+    uint32_t canvas;
+    bool valid;
+} ra8876_backing_entry_t;
+
+typedef struct {
+    uint32_t addr;
+    uint32_t slot_bytes;
+    uint16_t rows;
+    uint8_t pixel_bytes;
+    uint8_t slots;
+    uint8_t used;
+    uint8_t size[RA8876_PATTERN_MAX];
+} ra8876_pattern_cache_t;
+
+typedef struct ra8876_backing {
+    uint32_t pool_addr;
+    uint16_t pool_rows;
+    uint8_t depth;
+    uint16_t restored;
+    uint16_t invalidated;
+    ra8876_backing_entry_t stack[RA8876_BACKING_DEPTH];
+} ra8876_backing_t;
+
+typedef struct {
+    uint8_t type;
+    ra8876_rect_t rect;
+    uint32_t fg;
+    uint32_t bg;
+    uint32_t accent;
+    bool visible;
+    bool pressed;
+    bool dirty;
+    ra8876_rect_t damage;
+    int16_t value;
+    int16_t min;
+    int16_t max;
+    uint8_t selected;
+    uint8_t count;
+    uint8_t row_h;
+    const char *const *items;
+    char text[RA8876_UI_TEXT + 1];
+} ra8876_widget_t;
+
+typedef struct {
+    uint32_t bg;
+    uint8_t count;
+    uint8_t damage_count;
+    uint16_t redrawn;
+    ra8876_widget_t *widgets[RA8876_UI_MAX_WIDGETS];
+    ra8876_rect_t damage[RA8876_UI_DAMAGE_MAX];
+} ra8876_ui_t;
+
+typedef struct {
+    ra8876_rect_t rect;
+    int16_t src_x;
+    int16_t src_y;
+    uint32_t src_addr;
+    uint32_t color;
+} ra8876_frame_item_t;
+
+typedef struct {
+    uint32_t addr;
+    uint16_t count;
+    uint16_t ops_in;
+    uint16_t ops_out;
+    uint32_t px_in;
+    uint32_t px_out;
+    ra8876_frame_item_t items[RA8876_FRAME_MAX];
+} ra8876_frame_t;
+
+typedef void (*ra8876_span_fn)(void *ctx, uint16_t x, uint16_t y, uint16_t len, uint8_t *out);
+typedef bool (*ra8876_tile_fn)(void *ctx, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                               uint8_t *pixels, uint16_t stride);
+
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint8_t cols;
+    uint8_t rows;
+    uint8_t pixel_bytes;
+    bool keyed;
+    bool dual;
+    uint32_t bg;
+    uint8_t bg_px[3];
+    ra8876_tile_fn fn;
+    void *ctx;
+    uint16_t rendered;
+    uint16_t uploaded;
+    uint16_t slot_tile[2];
+    bool slot_drawn[2];
+    uint32_t slot_hash[2];
+    uint32_t hash[RA8876_TILE_MAX];
+    uint8_t state[RA8876_TILE_MAX];
+    uint8_t buf[2][RA8876_TILE_BYTES];
+} ra8876_tiles_t;
+
 bool ra8876_init(ra8876_t *dev, uint16_t width, uint16_t height);
 uint8_t ra8876_get_chip_id(ra8876_t *dev);
+bool ra8876_set_transport(ra8876_t *dev, const ra8876_transport_t *transport);
+void ra8876_set_streaming(ra8876_t *dev, bool enable);
+
+uint32_t ra8876_spi_calibrate(ra8876_t *dev, uint32_t max_hz, bool use_flash);
+bool ra8876_spi_verify(ra8876_t *dev);
+bool ra8876_spi_save(ra8876_t *dev);
 
 void ra8876_write_cmd(ra8876_t *dev, ra8876_reg_t reg);
 void ra8876_write_data(ra8876_t *dev, uint8_t data);
@@ -221,6 +578,10 @@ void ra8876_wait_vsync(ra8876_t *dev);
 void ra8876_fill_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t color);
 void ra8876_draw_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t color);
 void ra8876_draw_line(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color);
+void ra8876_draw_polyline(ra8876_t *dev, const ra8876_point_t *pts, size_t count, uint32_t color);
+void ra8876_draw_polygon(ra8876_t *dev, const ra8876_point_t *pts, size_t count, uint32_t color);
+bool ra8876_fill_polygon(ra8876_t *dev, const ra8876_point_t *pts, size_t count, uint32_t color);
+void ra8876_draw_line_fan(ra8876_t *dev, const ra8876_point_t *pts, size_t count, uint32_t color);
 void ra8876_fill_circle(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t radius, uint32_t color);
 void ra8876_draw_circle(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t radius, uint32_t color);
 void ra8876_fill_ellipse(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint32_t color);
@@ -230,6 +591,23 @@ void ra8876_draw_rounded_rect(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t w,
 void ra8876_fill_triangle(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint32_t color);
 void ra8876_draw_triangle(ra8876_t *dev, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint32_t color);
 void ra8876_fill_screen(ra8876_t *dev, uint32_t color);
+
+void ra8876_fill_rect_s(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+void ra8876_draw_rect_s(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+void ra8876_draw_line_s(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+void ra8876_fill_circle_s(ra8876_t *dev, int32_t x, int32_t y, int32_t radius, uint32_t color);
+void ra8876_draw_circle_s(ra8876_t *dev, int32_t x, int32_t y, int32_t radius, uint32_t color);
+void ra8876_fill_ellipse_s(ra8876_t *dev, int32_t x, int32_t y, int32_t rx, int32_t ry, uint32_t color);
+void ra8876_draw_ellipse_s(ra8876_t *dev, int32_t x, int32_t y, int32_t rx, int32_t ry, uint32_t color);
+void ra8876_fill_rounded_rect_s(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+void ra8876_draw_rounded_rect_s(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+void ra8876_fill_triangle_s(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+void ra8876_draw_triangle_s(ra8876_t *dev, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+
+bool ra8876_clip_push(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h);
+void ra8876_clip_pop(ra8876_t *dev);
+void ra8876_clip_reset(ra8876_t *dev);
+bool ra8876_clip_visible(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h);
 void ra8876_draw_curve(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint8_t quadrant, uint32_t color);
 void ra8876_fill_curve(ra8876_t *dev, uint16_t x, uint16_t y, uint16_t rx, uint16_t ry, uint8_t quadrant, uint32_t color);
 
@@ -244,6 +622,17 @@ void ra8876_put_string(ra8876_t *dev, const char *s);
 void ra8876_print(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *s);
 void ra8876_printf(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *fmt, ...);
 
+void ra8876_text_begin(ra8876_t *dev);
+void ra8876_text_run(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color, const char *s);
+void ra8876_text_end(ra8876_t *dev);
+void ra8876_print_runs(ra8876_t *dev, const ra8876_text_run_t *runs, size_t count);
+
+void ra8876_field_init(ra8876_field_t *f, uint16_t x, uint16_t y, uint8_t width, uint32_t fg, uint32_t bg);
+void ra8876_field_invalidate(ra8876_field_t *f);
+void ra8876_field_set_colors(ra8876_field_t *f, uint32_t fg, uint32_t bg);
+void ra8876_field_set(ra8876_t *dev, ra8876_field_t *f, const char *s);
+void ra8876_field_printf(ra8876_t *dev, ra8876_field_t *f, const char *fmt, ...);
+
 void ra8876_set_canvas_addr(ra8876_t *dev, uint32_t addr);
 void ra8876_set_canvas_page(ra8876_t *dev, uint8_t page);
 void ra8876_set_canvas(ra8876_t *dev, uint32_t addr, uint16_t width);
@@ -256,12 +645,19 @@ void ra8876_set_gamma(ra8876_t *dev, bool enable);
 
 void ra8876_buffer_init(ra8876_t *dev, uint8_t num_pages);
 void ra8876_swap_buffers(ra8876_t *dev);
+uint32_t ra8876_swap_buffers_group(ra8876_t *const *devs, uint8_t count);
 void ra8876_buffer_disable(ra8876_t *dev);
 uint8_t ra8876_get_draw_page(ra8876_t *dev);
 
+uint32_t ra8876_sdram_alloc(ra8876_t *dev, uint16_t rows);
+void ra8876_sdram_release(ra8876_t *dev, uint32_t addr);
+
 void ra8876_bte_copy(ra8876_t *dev, uint32_t src_addr, uint16_t src_x, uint16_t src_y,
                      uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
                      uint16_t width, uint16_t height, uint8_t rop);
+void ra8876_bte_copy_s(ra8876_t *dev, uint32_t src_addr, int32_t src_x, int32_t src_y,
+                       uint32_t dst_addr, int32_t dst_x, int32_t dst_y,
+                       int32_t width, int32_t height, uint8_t rop);
 
 void ra8876_bte_copy_chroma(ra8876_t *dev, uint32_t src_addr, uint16_t src_x, uint16_t src_y,
                             uint32_t dst_addr, uint16_t dst_x, uint16_t dst_y,
@@ -274,12 +670,20 @@ void ra8876_bte_blend(ra8876_t *dev, uint32_t s0_addr, uint16_t s0_x, uint16_t s
 
 void ra8876_bte_solid_fill(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
                            uint16_t width, uint16_t height, uint32_t color);
+void ra8876_bte_solid_fill_s(ra8876_t *dev, uint32_t addr, int32_t x, int32_t y,
+                             int32_t width, int32_t height, uint32_t color);
 
 void ra8876_bte_batch_start(ra8876_t *dev, uint32_t addr, uint16_t width, uint16_t height);
 void ra8876_bte_batch_fill(ra8876_t *dev, uint16_t x, uint16_t y, uint32_t color);
 
 void ra8876_bte_write(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
                       uint16_t width, uint16_t height, const uint8_t *data);
+void ra8876_bte_write_begin(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                            uint16_t width, uint16_t height);
+void ra8876_bte_write_data(ra8876_t *dev, const uint8_t *data, size_t len);
+void ra8876_bte_write_end(ra8876_t *dev);
+void ra8876_bte_write_gen(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                          uint16_t width, uint16_t height, ra8876_span_fn fn, void *ctx);
 
 void ra8876_bte_write_chroma(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
                              uint16_t width, uint16_t height,
@@ -307,6 +711,89 @@ void ra8876_bte_pattern_fill(ra8876_t *dev, uint32_t pattern_addr,
                              uint16_t width, uint16_t height,
                              bool pattern_16x16, uint8_t rop);
 
+bool ra8876_pattern_cache_init(ra8876_t *dev, ra8876_pattern_cache_t *cache, uint8_t slots);
+void ra8876_pattern_cache_free(ra8876_t *dev, ra8876_pattern_cache_t *cache);
+int8_t ra8876_pattern_add(ra8876_t *dev, ra8876_pattern_cache_t *cache, const uint8_t *pixels, uint8_t size);
+int8_t ra8876_pattern_add_mono(ra8876_t *dev, ra8876_pattern_cache_t *cache, const uint8_t *bits, uint8_t size,
+                               uint32_t fg, uint32_t bg);
+void ra8876_pattern_remove(ra8876_pattern_cache_t *cache, int8_t handle);
+void ra8876_pattern_fill(ra8876_t *dev, const ra8876_pattern_cache_t *cache, int8_t handle,
+                         uint32_t dst_addr, int32_t x, int32_t y, int32_t width, int32_t height, uint8_t rop);
+
+void ra8876_gradient_rect(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h,
+                          uint32_t c0, uint32_t c1, bool vertical, ra8876_pattern_cache_t *dither);
+void ra8876_gradient_rounded_rect(ra8876_t *dev, int32_t x, int32_t y, int32_t w, int32_t h, int32_t r,
+                                  uint32_t c0, uint32_t c1, bool vertical, ra8876_pattern_cache_t *dither);
+void ra8876_gradient_radial(ra8876_t *dev, int32_t x, int32_t y, int32_t rx, int32_t ry,
+                            uint32_t inner, uint32_t outer);
+
+bool ra8876_rle_info(const uint8_t *blob, size_t size, ra8876_rle_info_t *info);
+size_t ra8876_rle_write_header(uint8_t *out, uint16_t width, uint16_t height, uint8_t pixel_bytes);
+size_t ra8876_rle_encode(const uint8_t *pixels, size_t count, uint8_t pixel_bytes, uint8_t *out, size_t cap);
+bool ra8876_draw_rle(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, const uint8_t *blob, size_t size);
+bool ra8876_draw_rle_runs(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, const uint8_t *blob, size_t size);
+void ra8876_bte_write_runs(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y,
+                           uint16_t width, uint16_t height, const uint8_t *data);
+
+void ra8876_conv_init(ra8876_conv_t *c, uint16_t width, uint8_t bpp, uint8_t dither, int16_t *err);
+void ra8876_conv_rgb888(ra8876_conv_t *c, const uint8_t *src, uint8_t *dst, size_t count);
+void ra8876_conv_rgb565(ra8876_conv_t *c, const uint16_t *src, uint8_t *dst, size_t count);
+void ra8876_bte_write_rgb888(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                             const uint8_t *data, uint8_t dither, int16_t *err);
+void ra8876_bte_write_rgb565(ra8876_t *dev, uint32_t addr, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                             const uint16_t *data, uint8_t dither, int16_t *err);
+
+void ra8876_draw_line_aa(ra8876_t *dev, float x0, float y0, float x1, float y1, float width, uint32_t color);
+void ra8876_draw_circle_aa(ra8876_t *dev, float x, float y, float r, float width, uint32_t color);
+void ra8876_draw_arc_aa(ra8876_t *dev, float x, float y, float r, float start_deg, float end_deg,
+                        float width, uint32_t color);
+
+bool ra8876_transition_start(ra8876_t *dev, ra8876_transition_t *t, uint8_t kind, uint8_t dir,
+                             uint8_t from_page, uint8_t to_page, uint8_t work0, uint8_t work1,
+                             uint16_t duration_ms);
+void ra8876_transition_set_budget(ra8876_transition_t *t, uint32_t budget_us);
+bool ra8876_transition_step(ra8876_t *dev, ra8876_transition_t *t);
+void ra8876_transition_run(ra8876_t *dev, ra8876_transition_t *t);
+
+bool ra8876_backing_init(ra8876_t *dev, ra8876_backing_t *b, uint16_t rows);
+bool ra8876_backing_push(ra8876_t *dev, ra8876_backing_t *b, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+bool ra8876_backing_pop(ra8876_t *dev, ra8876_backing_t *b);
+void ra8876_backing_damage(ra8876_backing_t *b, uint32_t canvas, int32_t x, int32_t y, int32_t w, int32_t h);
+
+void ra8876_ui_init(ra8876_ui_t *ui, uint32_t bg);
+bool ra8876_ui_add(ra8876_ui_t *ui, ra8876_widget_t *w);
+void ra8876_ui_damage(ra8876_ui_t *ui, int16_t x, int16_t y, int16_t w, int16_t h);
+uint16_t ra8876_ui_update(ra8876_t *dev, ra8876_ui_t *ui);
+
+void ra8876_widget_init(ra8876_widget_t *w, uint8_t type, int16_t x, int16_t y, int16_t width, int16_t height,
+                        uint32_t fg, uint32_t bg, uint32_t accent);
+void ra8876_widget_set_text(ra8876_widget_t *w, const char *s);
+void ra8876_widget_set_range(ra8876_widget_t *w, int16_t min, int16_t max);
+void ra8876_widget_set_value(ra8876_widget_t *w, int16_t value);
+void ra8876_widget_set_items(ra8876_widget_t *w, const char *const *items, uint8_t count);
+void ra8876_widget_select(ra8876_widget_t *w, uint8_t index);
+void ra8876_widget_set_pressed(ra8876_widget_t *w, bool pressed);
+void ra8876_widget_set_visible(ra8876_ui_t *ui, ra8876_widget_t *w, bool visible);
+void ra8876_widget_move(ra8876_ui_t *ui, ra8876_widget_t *w, int16_t x, int16_t y);
+
+void ra8876_frame_begin(ra8876_frame_t *f, uint32_t addr);
+void ra8876_frame_fill(ra8876_t *dev, ra8876_frame_t *f, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+void ra8876_frame_copy(ra8876_t *dev, ra8876_frame_t *f, uint32_t src_addr, int32_t src_x, int32_t src_y,
+                       int32_t x, int32_t y, int32_t w, int32_t h);
+void ra8876_frame_flush(ra8876_t *dev, ra8876_frame_t *f);
+
+void ra8876_core1_start(void);
+void ra8876_core1_run(void (*fn)(void *), void *arg);
+void ra8876_core1_wait(void);
+
+bool ra8876_tiles_init(ra8876_t *dev, ra8876_tiles_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                       ra8876_tile_fn fn, void *ctx);
+void ra8876_tiles_set_background(ra8876_tiles_t *t, uint32_t color, bool keyed);
+void ra8876_tiles_set_dual_core(ra8876_tiles_t *t, bool enable);
+void ra8876_tiles_mark(ra8876_tiles_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void ra8876_tiles_invalidate(ra8876_tiles_t *t, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void ra8876_tiles_update(ra8876_t *dev, ra8876_tiles_t *t, uint32_t dst_addr);
+
 void ra8876_set_backlight(ra8876_t *dev, uint8_t brightness);
 void ra8876_display_on(ra8876_t *dev);
 void ra8876_display_off(ra8876_t *dev);
@@ -332,6 +819,10 @@ void ra8876_pip1_disable(ra8876_t *dev);
 void ra8876_pip2_enable(ra8876_t *dev, uint32_t src_addr, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
 void ra8876_pip2_move(ra8876_t *dev, uint16_t x, uint16_t y);
 void ra8876_pip2_disable(ra8876_t *dev);
+void ra8876_pip_set_depth(ra8876_t *dev, uint8_t pip, uint8_t bpp);
+
+bool ra8876_set_color_depth(ra8876_t *dev, uint8_t bpp);
+void ra8876_bte_set_source_depth(ra8876_t *dev, uint8_t s0_bpp, uint8_t s1_bpp);
 
 void ra8876_cgram_init(ra8876_t *dev);
 void ra8876_cgram_upload_font(ra8876_t *dev, const uint8_t *data, uint8_t first_char, uint8_t num_chars, uint8_t font_height);
@@ -341,6 +832,14 @@ void ra8876_select_cgram_font(ra8876_t *dev, uint8_t size);
 void ra8876_put_cgram_string_off(ra8876_t *dev, const char *str, uint8_t offset);
 void ra8876_put_cgram_string(ra8876_t *dev, const char *str);
 
+bool ra8876_chart_init(ra8876_t *dev, ra8876_chart_t *c, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                       int16_t *history, uint8_t num_traces, const uint32_t *colors);
+void ra8876_chart_set_colors(ra8876_chart_t *c, uint32_t bg, uint32_t grid, uint16_t grid_step);
+void ra8876_chart_set_range(ra8876_chart_t *c, int16_t lo, int16_t hi);
+void ra8876_chart_set_autoscale(ra8876_chart_t *c, bool enable);
+void ra8876_chart_push(ra8876_chart_t *c, const int16_t *samples);
+void ra8876_chart_update(ra8876_t *dev, ra8876_chart_t *c, uint32_t dst_addr);
+
 void ra8876_set_fg_color(ra8876_t *dev, uint32_t color);
 void ra8876_set_bg_color(ra8876_t *dev, uint32_t color);
 void ra8876_set_text_mode(ra8876_t *dev);
@@ -350,6 +849,14 @@ static inline uint32_t ra8876_rgb(uint8_t r, uint8_t g, uint8_t b) {
     return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
 }
 
+static inline uint32_t ra8876_unpack_rgb332(uint8_t c) {
+    return ra8876_rgb(c & 0xE0, (c << 3) & 0xE0, (c << 6) & 0xC0);
+}
+
+static inline uint8_t ra8876_pixel_bytes(ra8876_t *dev) {
+    return dev->bpp / 8;
+}
+
 static inline uint32_t ra8876_page_addr(ra8876_t *dev, uint8_t page) {
     return (uint32_t)page * dev->page_size;
 }
@@ -358,6 +865,28 @@ static inline uint8_t ra8876_pack_rgb332(uint8_t r, uint8_t g, uint8_t b) {
     return (r & 0xE0) | ((g >> 3) & 0x1C) | (b >> 6);
 }
 
+static inline uint16_t ra8876_pack_rgb565(uint8_t r, uint8_t g, uint8_t b) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+static inline uint8_t ra8876_put_pixel(ra8876_t *dev, uint8_t *out, uint32_t color) {
+    uint8_t r = color >> 16, g = color >> 8, b = color;
+    if (dev->bpp == 24) {
+        out[0] = b;
+        out[1] = g;
+        out[2] = r;
+        return 3;
+    }
+    if (dev->bpp == 16) {
+        uint16_t v = ra8876_pack_rgb565(r, g, b);
+        out[0] = v & 0xFF;
+        out[1] = v >> 8;
+        return 2;
+    }
+    out[0] = ra8876_pack_rgb332(r, g, b);
+    return 1;
+}
+
 static inline uint8_t ra8876_scale_x(ra8876_t *dev) {
     return ((dev->regCD >> 2) & 3) + 1;
 }
@@ -366,4 +895,12 @@ static inline uint8_t ra8876_scale_y(ra8876_t *dev) {
     return (dev->regCD & 3) + 1;
 }
 
+static inline uint16_t ra8876_char_advance(ra8876_t *dev) {
+    return dev->char_width * ra8876_scale_x(dev) + dev->regD1;
+}
+
+static inline uint16_t ra8876_line_pitch(ra8876_t *dev) {
+    return dev->char_height * ra8876_scale_y(dev) + dev->regD0;
+}
+
 #endif
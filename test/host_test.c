@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <string.h>
+#include "ra8876.h"
+#include "mock_transport.h"
+
+static int failures;
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                \
+        }                                                              \
+    } while (0)
+
+static ra8876_t dev;
+
+static bool open_mock(const ra8876_transport_t *transport, bool streaming) {
+    mock_reset();
+    memset(&dev, 0, sizeof(dev));
+    dev.transport = transport;
+    if (!ra8876_init(&dev, 1024, 600)) return false;
+    ra8876_set_streaming(&dev, streaming);
+    mock_clear_log();
+    return true;
+}
+
+static size_t flatten(uint32_t *out, size_t max) {
+    size_t n = 0;
+    for (size_t i = 0; i < mock_bus.count && n < max; i++) {
+        const mock_cycle_t *c = &mock_bus.log[i];
+        if (c->read) {
+            out[n++] = 0x10000 | c->cycle;
+            continue;
+        }
+        for (uint16_t k = 0; k < c->len && k < MOCK_DATA_MAX && n < max; k++)
+            out[n++] = ((uint32_t)c->cycle << 8) | c->data[k];
+    }
+    return n;
+}
+
+static void test_register_write(void) {
+    CHECK(open_mock(&mock_transport, true));
+    ra8876_write_reg(&dev, RA8876_DCR1, 0xA5);
+    CHECK(mock_bus.count == 2);
+    CHECK(mock_bus.log[0].cycle == RA8876_CYCLE_CMD && mock_bus.log[0].len == 1);
+    CHECK(mock_bus.log[0].data[0] == RA8876_DCR1 && !mock_bus.log[0].framed);
+    CHECK(mock_bus.log[1].cycle == RA8876_CYCLE_DATA && mock_bus.log[1].len == 1);
+    CHECK(mock_bus.log[1].data[0] == 0xA5 && !mock_bus.log[1].framed);
+    CHECK(mock_bus.regs[RA8876_DCR1] == 0xA5);
+    CHECK(mock_bus.frame_calls == 0);
+
+    CHECK(ra8876_read_reg(&dev, 0xFF) == 0x76);
+    CHECK(mock_bus.count == 4 && mock_bus.log[3].read && mock_bus.log[3].cycle == RA8876_CYCLE_READ);
+}
+
+static void test_burst(void) {
+    uint8_t data[2 * RA8876_BURST_SIZE + 5];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 7 + 1);
+    CHECK(open_mock(&mock_transport, true));
+    ra8876_write_data_burst(&dev, data, sizeof(data));
+    CHECK(mock_bus.count == 6);
+    size_t offset = 0;
+    for (size_t i = 0; i + 1 < mock_bus.count; i += 2) {
+        const mock_cycle_t *status = &mock_bus.log[i], *burst = &mock_bus.log[i + 1];
+        size_t chunk = sizeof(data) - offset < RA8876_BURST_SIZE ? sizeof(data) - offset : RA8876_BURST_SIZE;
+        CHECK(status->read && status->cycle == RA8876_CYCLE_STATUS);
+        CHECK(!burst->read && burst->cycle == RA8876_CYCLE_DATA && burst->len == chunk);
+        CHECK(memcmp(burst->data, &data[offset], chunk) == 0);
+        offset += chunk;
+    }
+    CHECK(offset == sizeof(data));
+}
+
+static size_t fill_trace(const ra8876_transport_t *transport, bool streaming, uint32_t *out, size_t max) {
+    if (!open_mock(transport, streaming)) return 0;
+    ra8876_bte_solid_fill(&dev, dev.canvas_addr, 100, 50, 300, 200, RA8876_RED);
+    ra8876_fill_triangle(&dev, 10, 10, 200, 40, 60, 180, RA8876_GREEN);
+    return flatten(out, max);
+}
+
+static void test_write_frames(void) {
+    static uint32_t framed[MOCK_LOG_MAX], direct[MOCK_LOG_MAX], unframed[MOCK_LOG_MAX];
+
+    size_t n = fill_trace(&mock_transport, true, framed, MOCK_LOG_MAX);
+    CHECK(n > 0 && mock_bus.dropped == 0);
+    CHECK(mock_bus.frame_calls > 0);
+    CHECK(mock_bus.frame_calls <= 4);
+    size_t in_frames = 0;
+    for (size_t i = 0; i < mock_bus.count; i++) in_frames += mock_bus.log[i].framed;
+    CHECK(in_frames == mock_bus.frames);
+    CHECK(mock_bus.frames <= RA8876_STREAM_MAX * mock_bus.frame_calls);
+
+    size_t m = fill_trace(&mock_transport, false, direct, MOCK_LOG_MAX);
+    CHECK(mock_bus.frame_calls == 0);
+    CHECK(m == n && memcmp(framed, direct, n * sizeof(uint32_t)) == 0);
+
+    size_t k = fill_trace(&mock_transport_unframed, true, unframed, MOCK_LOG_MAX);
+    CHECK(mock_bus.frame_calls == 0);
+    CHECK(k == n && memcmp(framed, unframed, n * sizeof(uint32_t)) == 0);
+}
+
+static void test_sdram_release(void) {
+    CHECK(open_mock(&mock_transport, true));
+    uint32_t top = dev.sdram_top;
+    uint32_t a = ra8876_sdram_alloc(&dev, 10);
+    CHECK(a != RA8876_SDRAM_NONE && a == top - 10u * 1024);
+    CHECK(ra8876_set_color_depth(&dev, 16));
+    uint32_t b = ra8876_sdram_alloc(&dev, 10);
+    CHECK(b == a - 10u * 1024 * 2);
+    ra8876_sdram_release(&dev, a);
+    CHECK(dev.sdram_top == b);
+    ra8876_sdram_release(&dev, a);
+    CHECK(dev.sdram_top == b);
+    ra8876_sdram_release(&dev, b);
+    CHECK(dev.sdram_top == top);
+    CHECK(dev.sdram_blocks == 0);
+}
+
+static void test_pattern_cache_no_sdram(void) {
+    ra8876_pattern_cache_t cache;
+    uint8_t pixels[8 * 8] = { 0 };
+    CHECK(open_mock(&mock_transport, true));
+    while (ra8876_sdram_alloc(&dev, dev.height) != RA8876_SDRAM_NONE) {}
+    memset(&cache, 0xA5, sizeof(cache));
+    CHECK(!ra8876_pattern_cache_init(&dev, &cache, 8));
+    CHECK(cache.slots == 0 && cache.used == 0);
+    mock_clear_log();
+    CHECK(ra8876_pattern_add(&dev, &cache, pixels, 8) == RA8876_PATTERN_NONE);
+    ra8876_pattern_fill(&dev, &cache, 0, dev.canvas_addr, 0, 0, 16, 16, RA8876_ROP_S);
+    CHECK(mock_bus.count == 0);
+}
+
+static void test_polygon_no_ear(void) {
+    const ra8876_point_t star[5] = { { 100, 10 }, { 160, 190 }, { 10, 70 }, { 190, 70 }, { 40, 190 } };
+    const ra8876_point_t square[4] = { { 10, 10 }, { 60, 10 }, { 60, 60 }, { 10, 60 } };
+    CHECK(open_mock(&mock_transport, true));
+    mock_clear_log();
+    CHECK(!ra8876_fill_polygon(&dev, star, 5, 0xFF));
+    CHECK(mock_bus.count == 0);
+    CHECK(ra8876_fill_polygon(&dev, square, 4, 0xFF));
+    CHECK(mock_bus.count > 0);
+}
+
+int main(void) {
+    test_register_write();
+    test_burst();
+    test_write_frames();
+    test_sdram_release();
+    test_pattern_cache_no_sdram();
+    test_polygon_no_ear();
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <string.h>
+#include "mock_transport.h"
+
+mock_bus_t mock_bus;
+
+void mock_clear_log(void) {
+    mock_bus.count = 0;
+    mock_bus.dropped = 0;
+    mock_bus.frame_calls = 0;
+    mock_bus.frames = 0;
+}
+
+void mock_reset(void) {
+    memset(&mock_bus, 0, sizeof(mock_bus));
+    mock_bus.status = 0x44;
+    mock_bus.read_regs[0x01] = 0x80;
+    mock_bus.read_regs[0x0C] = 0x10;
+    mock_bus.read_regs[0xFF] = 0x76;
+}
+
+static mock_cycle_t *mock_record(uint8_t cycle, bool read, bool framed) {
+    if (mock_bus.count == MOCK_LOG_MAX) {
+        mock_bus.dropped++;
+        return NULL;
+    }
+    mock_cycle_t *c = &mock_bus.log[mock_bus.count++];
+    c->cycle = cycle;
+    c->read = read;
+    c->framed = framed;
+    c->len = 0;
+    return c;
+}
+
+static void mock_apply(uint8_t cycle, const uint8_t *data, size_t len) {
+    if (cycle == RA8876_CYCLE_CMD && len) mock_bus.reg = data[len - 1];
+    else if (cycle == RA8876_CYCLE_DATA && len == 1) mock_bus.regs[mock_bus.reg] = data[0];
+}
+
+static bool mock_open(ra8876_t *dev) {
+    return true;
+}
+
+static void mock_close(ra8876_t *dev) {}
+
+static void mock_write(ra8876_t *dev, uint8_t cycle, const uint8_t *data, size_t len) {
+    mock_cycle_t *c = mock_record(cycle, false, false);
+    if (c) {
+        c->len = len;
+        memcpy(c->data, data, len < MOCK_DATA_MAX ? len : MOCK_DATA_MAX);
+    }
+    mock_apply(cycle, data, len);
+}
+
+static uint8_t mock_read(ra8876_t *dev, uint8_t cycle) {
+    uint8_t v = cycle == RA8876_CYCLE_STATUS ? mock_bus.status : mock_bus.read_regs[mock_bus.reg];
+    mock_cycle_t *c = mock_record(cycle, true, false);
+    if (c) {
+        c->len = 1;
+        c->data[0] = v;
+    }
+    return v;
+}
+
+static void mock_write_frames(ra8876_t *dev, const uint16_t *frames, size_t count) {
+    mock_bus.frame_calls++;
+    mock_bus.frames += count;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t cycle = frames[i] >> 8, d = frames[i] & 0xFF;
+        mock_cycle_t *c = mock_record(cycle, false, true);
+        if (c) {
+            c->len = 1;
+            c->data[0] = d;
+        }
+        mock_apply(cycle, &d, 1);
+    }
+}
+
+const ra8876_transport_t mock_transport = {
+    .name = "mock",
+    .open = mock_open,
+    .close = mock_close,
+    .write = mock_write,
+    .read = mock_read,
+    .write_frames = mock_write_frames,
+};
+
+const ra8876_transport_t mock_transport_unframed = {
+    .name = "mock unframed",
+    .open = mock_open,
+    .close = mock_close,
+    .write = mock_write,
+    .read = mock_read,
+};
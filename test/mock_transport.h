@@ -0,0 +1,36 @@
+#ifndef MOCK_TRANSPORT_H
+#define MOCK_TRANSPORT_H
+
+#include "ra8876.h"
+
+#define MOCK_LOG_MAX  4096
+#define MOCK_DATA_MAX 64
+
+typedef struct {
+    uint8_t cycle;
+    bool read;
+    bool framed;
+    uint16_t len;
+    uint8_t data[MOCK_DATA_MAX];
+} mock_cycle_t;
+
+typedef struct {
+    mock_cycle_t log[MOCK_LOG_MAX];
+    size_t count;
+    size_t dropped;
+    uint32_t frame_calls;
+    uint32_t frames;
+    uint8_t reg;
+    uint8_t status;
+    uint8_t regs[256];
+    uint8_t read_regs[256];
+} mock_bus_t;
+
+extern mock_bus_t mock_bus;
+extern const ra8876_transport_t mock_transport;
+extern const ra8876_transport_t mock_transport_unframed;
+
+void mock_reset(void);
+void mock_clear_log(void);
+
+#endif
@@ -0,0 +1,103 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+uint8_t host_xip[PICO_FLASH_SIZE_BYTES];
+
+static uint64_t host_time;
+static spi_hw_t host_spi_hw;
+
+void stdio_init_all(void) {}
+void sleep_ms(uint32_t ms) { host_time += (uint64_t)ms * 1000; }
+void sleep_us(uint64_t us) { host_time += us; }
+uint32_t time_us_32(void) { return (uint32_t)++host_time; }
+uint64_t time_us_64(void) { return ++host_time; }
+
+void gpio_init(unsigned gpio) {}
+void gpio_set_dir(unsigned gpio, bool out) {}
+void gpio_put(unsigned gpio, bool value) {}
+void gpio_set_function(unsigned gpio, enum gpio_function fn) {}
+
+uint32_t clock_get_hz(enum clock_index clk_index) { return 150000000; }
+uint32_t save_and_disable_interrupts(void) { return 0; }
+void restore_interrupts(uint32_t status) {}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) { memset(&host_xip[flash_offs], 0xFF, count); }
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    for (size_t i = 0; i < count; i++) host_xip[flash_offs + i] &= data[i];
+}
+
+void multicore_launch_core1(void (*entry)(void)) {}
+void multicore_fifo_push_blocking(uint32_t data) {}
+uint32_t multicore_fifo_pop_blocking(void) { return 0; }
+
+unsigned spi_init(spi_inst_t *spi, unsigned baudrate) { return baudrate; }
+unsigned spi_set_baudrate(spi_inst_t *spi, unsigned baudrate) { return baudrate; }
+void spi_set_format(spi_inst_t *spi, unsigned data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {}
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) { return (int)len; }
+
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len) {
+    memset(dst, 0, len);
+    return (int)len;
+}
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi) { return &host_spi_hw; }
+unsigned spi_get_dreq(spi_inst_t *spi, bool is_tx) { return 0; }
+bool spi_is_busy(const spi_inst_t *spi) { return false; }
+bool spi_is_readable(const spi_inst_t *spi) { return false; }
+
+int dma_claim_unused_channel(bool required) { return 0; }
+void dma_channel_unclaim(unsigned channel) {}
+dma_channel_config dma_channel_get_default_config(unsigned channel) { return (dma_channel_config){ 0 }; }
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {}
+void channel_config_set_dreq(dma_channel_config *c, unsigned dreq) {}
+void channel_config_set_bswap(dma_channel_config *c, bool bswap) {}
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {}
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {}
+void dma_channel_configure(unsigned channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, unsigned transfer_count, bool trigger) {}
+void dma_channel_transfer_from_buffer_now(unsigned channel, const volatile void *read_addr, uint32_t transfer_count) {}
+void dma_channel_wait_for_finish_blocking(unsigned channel) {}
+
+unsigned pio_encode_delay(unsigned cycles) { return 0; }
+unsigned pio_encode_sideset(unsigned sideset_bit_count, unsigned value) { return 0; }
+unsigned pio_encode_jmp(unsigned addr) { return 0; }
+unsigned pio_encode_jmp_not_x(unsigned addr) { return 0; }
+unsigned pio_encode_jmp_x_dec(unsigned addr) { return 0; }
+unsigned pio_encode_jmp_not_y(unsigned addr) { return 0; }
+unsigned pio_encode_jmp_y_dec(unsigned addr) { return 0; }
+unsigned pio_encode_in(enum pio_src_dest src, unsigned count) { return 0; }
+unsigned pio_encode_out(enum pio_src_dest dest, unsigned count) { return 0; }
+unsigned pio_encode_pull(bool if_empty, bool block) { return 0; }
+unsigned pio_encode_set(enum pio_src_dest dest, unsigned value) { return 0; }
+unsigned pio_encode_nop(void) { return 0; }
+
+pio_sm_config pio_get_default_sm_config(void) { return (pio_sm_config){ 0 }; }
+void sm_config_set_out_pins(pio_sm_config *c, unsigned out_base, unsigned out_count) {}
+void sm_config_set_set_pins(pio_sm_config *c, unsigned set_base, unsigned set_count) {}
+void sm_config_set_in_pins(pio_sm_config *c, unsigned in_base) {}
+void sm_config_set_sideset_pins(pio_sm_config *c, unsigned sideset_base) {}
+void sm_config_set_sideset(pio_sm_config *c, unsigned bit_count, bool optional, bool pindirs) {}
+void sm_config_set_wrap(pio_sm_config *c, unsigned wrap_target, unsigned wrap) {}
+void sm_config_set_clkdiv(pio_sm_config *c, float div) {}
+void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, unsigned pull_threshold) {}
+void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, unsigned push_threshold) {}
+bool pio_claim_free_sm_and_add_program(const pio_program_t *program, PIO *pio, unsigned *sm, unsigned *offset) {
+    return false;
+}
+void pio_remove_program_and_unclaim_sm(const pio_program_t *program, PIO pio, unsigned sm, unsigned offset) {}
+int pio_sm_init(PIO pio, unsigned sm, unsigned initial_pc, const pio_sm_config *config) { return 0; }
+void pio_sm_set_enabled(PIO pio, unsigned sm, bool enabled) {}
+void pio_gpio_init(PIO pio, unsigned pin) {}
+void pio_sm_set_pins_with_mask(PIO pio, unsigned sm, uint32_t pin_values, uint32_t pin_mask) {}
+void pio_sm_set_pindirs_with_mask(PIO pio, unsigned sm, uint32_t pin_dirs, uint32_t pin_mask) {}
+void pio_sm_put_blocking(PIO pio, unsigned sm, uint32_t data) {}
+uint32_t pio_sm_get_blocking(PIO pio, unsigned sm) { return 0; }
+unsigned pio_get_dreq(PIO pio, unsigned sm, bool is_tx) { return 0; }
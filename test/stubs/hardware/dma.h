@@ -0,0 +1,22 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(unsigned channel);
+dma_channel_config dma_channel_get_default_config(unsigned channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_dreq(dma_channel_config *c, unsigned dreq);
+void channel_config_set_bswap(dma_channel_config *c, bool bswap);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void dma_channel_configure(unsigned channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, unsigned transfer_count, bool trigger);
+void dma_channel_transfer_from_buffer_now(unsigned channel, const volatile void *read_addr, uint32_t transfer_count);
+void dma_channel_wait_for_finish_blocking(unsigned channel);
@@ -0,0 +1,13 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+enum gpio_function { GPIO_FUNC_SPI = 1, GPIO_FUNC_SIO = 5, GPIO_FUNC_PIO0 = 6, GPIO_FUNC_PIO1 = 7 };
+
+#define GPIO_OUT 1
+#define GPIO_IN  0
+
+void gpio_init(unsigned gpio);
+void gpio_set_dir(unsigned gpio, bool out);
+void gpio_put(unsigned gpio, bool value);
+void gpio_set_function(unsigned gpio, enum gpio_function fn);
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/pio_instructions.h"
+
+typedef struct {
+    volatile uint32_t ctrl, fstat, fdebug, flevel;
+    volatile uint32_t txf[4];
+    volatile uint32_t rxf[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+#define pio0 ((pio_hw_t *)0x50200000u)
+#define pio1 ((pio_hw_t *)0x50300000u)
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+    uint8_t pio_version;
+} pio_program_t;
+
+typedef struct {
+    uint32_t clkdiv, execctrl, shiftctrl, pinctrl;
+} pio_sm_config;
+
+pio_sm_config pio_get_default_sm_config(void);
+void sm_config_set_out_pins(pio_sm_config *c, unsigned out_base, unsigned out_count);
+void sm_config_set_set_pins(pio_sm_config *c, unsigned set_base, unsigned set_count);
+void sm_config_set_in_pins(pio_sm_config *c, unsigned in_base);
+void sm_config_set_sideset_pins(pio_sm_config *c, unsigned sideset_base);
+void sm_config_set_sideset(pio_sm_config *c, unsigned bit_count, bool optional, bool pindirs);
+void sm_config_set_wrap(pio_sm_config *c, unsigned wrap_target, unsigned wrap);
+void sm_config_set_clkdiv(pio_sm_config *c, float div);
+void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, unsigned pull_threshold);
+void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, unsigned push_threshold);
+bool pio_claim_free_sm_and_add_program(const pio_program_t *program, PIO *pio, unsigned *sm, unsigned *offset);
+void pio_remove_program_and_unclaim_sm(const pio_program_t *program, PIO pio, unsigned sm, unsigned offset);
+int pio_sm_init(PIO pio, unsigned sm, unsigned initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, unsigned sm, bool enabled);
+void pio_gpio_init(PIO pio, unsigned pin);
+void pio_sm_set_pins_with_mask(PIO pio, unsigned sm, uint32_t pin_values, uint32_t pin_mask);
+void pio_sm_set_pindirs_with_mask(PIO pio, unsigned sm, uint32_t pin_dirs, uint32_t pin_mask);
+void pio_sm_put_blocking(PIO pio, unsigned sm, uint32_t data);
+uint32_t pio_sm_get_blocking(PIO pio, unsigned sm);
+unsigned pio_get_dreq(PIO pio, unsigned sm, bool is_tx);
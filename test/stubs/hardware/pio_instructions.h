@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+enum pio_src_dest {
+    pio_pins = 0,
+    pio_x = 1,
+    pio_y = 2,
+    pio_null = 3,
+    pio_pindirs = 4,
+    pio_exec_mov = 4,
+    pio_status = 5,
+    pio_pc = 5,
+    pio_isr = 6,
+    pio_osr = 7,
+    pio_exec_out = 7,
+};
+
+unsigned pio_encode_delay(unsigned cycles);
+unsigned pio_encode_sideset(unsigned sideset_bit_count, unsigned value);
+unsigned pio_encode_jmp(unsigned addr);
+unsigned pio_encode_jmp_not_x(unsigned addr);
+unsigned pio_encode_jmp_x_dec(unsigned addr);
+unsigned pio_encode_jmp_not_y(unsigned addr);
+unsigned pio_encode_jmp_y_dec(unsigned addr);
+unsigned pio_encode_in(enum pio_src_dest src, unsigned count);
+unsigned pio_encode_out(enum pio_src_dest dest, unsigned count);
+unsigned pio_encode_pull(bool if_empty, bool block);
+unsigned pio_encode_set(enum pio_src_dest dest, unsigned value);
+unsigned pio_encode_nop(void);
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct {
+    volatile uint32_t cr0, cr1, dr, sr, cpsr, imsc, ris, mis, icr, dmacr;
+} spi_hw_t;
+
+typedef struct spi_inst spi_inst_t;
+
+#define spi0 ((spi_inst_t *)0x40080000u)
+#define spi1 ((spi_inst_t *)0x40088000u)
+
+#define SPI_SSPSR_TNF_BITS    0x02
+#define SPI_SSPSR_RNE_BITS    0x04
+#define SPI_SSPSR_BSY_BITS    0x10
+#define SPI_SSPICR_RORIC_BITS 0x01
+
+typedef enum { SPI_CPOL_0, SPI_CPOL_1 } spi_cpol_t;
+typedef enum { SPI_CPHA_0, SPI_CPHA_1 } spi_cpha_t;
+typedef enum { SPI_LSB_FIRST, SPI_MSB_FIRST } spi_order_t;
+
+unsigned spi_init(spi_inst_t *spi, unsigned baudrate);
+unsigned spi_set_baudrate(spi_inst_t *spi, unsigned baudrate);
+void spi_set_format(spi_inst_t *spi, unsigned data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len);
+spi_hw_t *spi_get_hw(spi_inst_t *spi);
+unsigned spi_get_dreq(spi_inst_t *spi, bool is_tx);
+bool spi_is_busy(const spi_inst_t *spi);
+bool spi_is_readable(const spi_inst_t *spi);
+
+static inline unsigned spi_get_index(const spi_inst_t *spi) { return spi == spi1; }
@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hardware/gpio.h"
+
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#define XIP_BASE ((uintptr_t)host_xip)
+#define __not_in_flash_func(f) f
+
+extern uint8_t host_xip[PICO_FLASH_SIZE_BYTES];
+
+void stdio_init_all(void);
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+
+static inline void tight_loop_contents(void) {}
+static inline unsigned get_core_num(void) { return 0; }